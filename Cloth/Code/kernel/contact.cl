@@ -0,0 +1,200 @@
+/// @file
+/// @brief    Spatial hash: contact forces (one work-item per node).
+/// @details  The 27 cells around the node are reduced to their distinct bins first, so that a bin
+///           reached from two cells (hash collision) is visited once. A triangle stored in several
+///           bins (see "grid_triangle.cl") is counted only in the bin of its closest point.
+
+__kernel void thekernel(__global int*       color,                              // Color (RGBA8).
+                        __global float4*    position,                           // Position.
+                        __global float4*    velocity,                           // Velocity.
+                        __global float4*    acceleration,                       // Acceleration.
+                        __global float4*    position_int,                       // Position (intermediate).
+                        __global float4*    velocity_int,                       // Velocity (intermediate).
+                        __global float4*    gravity,                            // Gravity.
+                        __global float*     stiffness,                          // Stiffness.
+                        __global float*     resting,                            // Resting distance.
+                        __global float*     friction,                           // Friction.
+                        __global float*     mass,                               // Mass.
+                        __global int*       nearest,                            // Neighbour.
+                        __global int*       offset,                             // Offset.
+                        __global int*       freedom,                            // Freedom flag.
+                        __global float*     dt_simulation,                      // Simulation time step.
+                        __global int*       cell_count,                         // Grid cell node count.
+                        __global int*       cell_node,                          // Grid cell nodes.
+                        __global int*       cell_triangle_count,                // Grid cell triangle count.
+                        __global int*       cell_triangle,                      // Grid cell triangles.
+                        __global int*       triangle,                           // Triangle vertices.
+                        __global float4*    contact_force,                      // Contact force.
+                        __global float*     contact,                            // Contact parameters.
+                        __global int*       grid,                               // Grid parameters.
+                        __global float*     watch_partial,                      // Watchdog partial reductions.
+                        __global float*     watch,                              // Watchdog reductions.
+                        __global int*       watchdog,                           // Watchdog parameters.
+                        __global float4*    checkpoint_position,                // Position (checkpoint).
+                        __global float4*    checkpoint_velocity,                // Velocity (checkpoint).
+                        __global float4*    checkpoint_acceleration,            // Acceleration (checkpoint).
+                        __global int*       bucket_node,                        // Nodes (sorted by degree).
+                        __global int*       bucket,                             // Bucket parameters.
+                        __global int*       patch_index,                        // Patch indices.
+                        __global float*     patch_value,                        // Patch values.
+                        __global int*       patch)                              // Patch parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i = get_global_id(0);                                            // Global index [#].
+  unsigned int j = 0;                                                           // Neighbour stride index.
+  unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
+  unsigned int j_max = offset[i];                                               // Neighbour stride maximum index.
+  int          s = 0;                                                           // Cell slot index.
+  int          s_max = 0;                                                       // Cell slot maximum index.
+  int          k = 0;                                                           // Other node (or triangle) index.
+  int          c = 0;                                                           // Cell hash.
+  int4         cell;                                                            // Central node cell.
+  int4         near;                                                            // Neighbour cell.
+  int          bin[27];                                                         // Distinct neighbour bins.
+  int          bins = 0;                                                        // Distinct neighbour bins [#].
+  int          n = 0;                                                           // Bin index.
+  int          m = 0;                                                           // Bin index (check).
+  bool         seen;                                                            // "true" if bin already listed.
+  int4         lo;                                                              // Triangle bounding box minimum cell.
+  int4         hi;                                                              // Triangle bounding box maximum cell.
+  bool         linked;                                                          // "true" if linked to central node.
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  float4        p                 = load_state(position_int, i);                // Central node position (intermediate).
+  float         h                 = contact[0];                                 // Grid cell size [m].
+  float         r                 = contact[1];                                 // Contact radius [m].
+  float         Kc                = contact[2];                                 // Contact stiffness [kg/s^2].
+  float4        O                 = (float4)(contact[3], contact[4], contact[5], 1.0f); // Obstacle center [m].
+  float         RO                = contact[6];                                 // Obstacle radius [m].
+  int           cells             = grid[0];                                    // Number of grid cells [#].
+  int           node_capacity     = grid[1];                                    // Nodes per cell [#].
+  int           triangle_capacity = grid[2];                                    // Triangles per cell [#].
+  float4        Fc                = (float4)(0.0f, 0.0f, 0.0f, 0.0f);           // Contact force.
+  float4        q;                                                              // Closest point.
+  float4        d;                                                              // Separation vector.
+  float         L;                                                              // Separation distance.
+  int           a;                                                              // Triangle vertex "a".
+  int           b;                                                              // Triangle vertex "b".
+  int           e;                                                              // Triangle vertex "c".
+  float4        A;                                                              // Triangle vertex "a" position.
+  float4        B;                                                              // Triangle vertex "b" position.
+  float4        C;                                                              // Triangle vertex "c" position.
+
+  // COMPUTING STRIDE MINIMUM INDEX:
+  if (i == 0)
+  {
+    j_min = 0;                                                                  // Setting stride minimum (first stride)...
+  }
+  else
+  {
+    j_min = offset[i - 1];                                                      // Setting stride minimum (all others)...
+  }
+
+  cell = cell_index(p, h);                                                      // Computing central node cell...
+
+  // LISTING DISTINCT NEIGHBOUR BINS:
+  for (near.z = cell.z - 1; near.z <= cell.z + 1; near.z++)
+  {
+    for (near.y = cell.y - 1; near.y <= cell.y + 1; near.y++)
+    {
+      for (near.x = cell.x - 1; near.x <= cell.x + 1; near.x++)
+      {
+        c = cell_hash(near, cells);                                             // Computing cell hash...
+        seen = false;                                                           // Resetting bin check...
+
+        for (m = 0; (m < bins) && !seen; m++)
+        {
+          seen = (bin[m] == c);                                                 // Checking bin already listed...
+        }
+
+        if (!seen)
+        {
+          bin[bins++] = c;                                                      // Listing bin...
+        }
+      }
+    }
+  }
+
+  // VISITING NEIGHBOUR BINS:
+  for (n = 0; n < bins; n++)
+  {
+    c = bin[n];                                                                 // Getting bin...
+
+    // NODE-NODE PROXIMITY:
+    s_max = min(cell_count[c], node_capacity);                                  // Getting cell node count...
+
+    for (s = 0; s < s_max; s++)
+    {
+      k = cell_node[c*node_capacity + s];                                       // Getting other node...
+      linked = (k == (int)i);                                                   // Skipping central node...
+
+      for (j = j_min; (j < j_max) && !linked; j++)
+      {
+        linked = (nearest[j] == k);                                             // Skipping linked nodes...
+      }
+
+      d = p - load_state(position_int, k);                                      // Computing separation...
+      d.w = 0.0f;                                                               // Adjusting projective space...
+      L = length(d);                                                            // Computing distance...
+
+      if (!linked && (L < r) && (L > 0.0f))
+      {
+        Fc += Kc*(r - L)*(d/L);                                                 // Building up repulsion...
+      }
+    }
+
+    // NODE-TRIANGLE PROXIMITY:
+    s_max = min(cell_triangle_count[c], triangle_capacity);                     // Getting cell triangle count...
+
+    for (s = 0; s < s_max; s++)
+    {
+      k = cell_triangle[c*triangle_capacity + s];                               // Getting triangle...
+      a = triangle[3*k + 0];                                                    // Getting vertex "a"...
+      b = triangle[3*k + 1];                                                    // Getting vertex "b"...
+      e = triangle[3*k + 2];                                                    // Getting vertex "c"...
+
+      if ((a == (int)i) || (b == (int)i) || (e == (int)i))
+      {
+        continue;                                                               // Skipping own triangles...
+      }
+
+      A = load_state(position_int, a);                                          // Getting vertex "a" position...
+      B = load_state(position_int, b);                                          // Getting vertex "b" position...
+      C = load_state(position_int, e);                                          // Getting vertex "c" position...
+      lo = cell_index(fmin(fmin(A, B), C), h);                                  // Computing bounding box minimum cell...
+      hi = cell_index(fmax(fmax(A, B), C), h);                                  // Computing bounding box maximum cell...
+      q = closest_point(p, A, B, C);                                            // Computing closest point...
+
+      if (cell_hash(clamp(cell_index(q, h), lo, hi), cells) != c)
+      {
+        continue;                                                               // Skipping triangle (counted in the bin of its closest point)...
+      }
+
+      d = p - q;                                                                // Computing separation...
+      d.w = 0.0f;                                                               // Adjusting projective space...
+      L = length(d);                                                            // Computing distance...
+
+      if ((L < r) && (L > 0.0f))
+      {
+        Fc += Kc*(r - L)*(d/L);                                                 // Building up repulsion...
+      }
+    }
+  }
+
+  // OBSTACLE CONTACT:
+  d = p - O;                                                                    // Computing obstacle separation...
+  d.w = 0.0f;                                                                   // Adjusting projective space...
+  L = length(d);                                                                // Computing obstacle distance...
+
+  if ((L < (RO + r)) && (L > 0.0f))
+  {
+    Fc += Kc*(RO + r - L)*(d/L);                                                // Building up obstacle reaction...
+  }
+
+  Fc.w = 1.0f;                                                                  // Adjusting projective space...
+  contact_force[i] = Fc;                                                        // Updating contact force...
+}
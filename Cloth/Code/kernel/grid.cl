@@ -0,0 +1,89 @@
+/// @file     grid.cl
+/// @brief    Uniform grid spatial hashing.
+/// @details  Cell indexing, cell hashing, cell box walking and point-triangle closest point.
+
+int4 cell_index (float4 p, float h)
+{
+  return convert_int4_rtn(floor(p/h));                                          // Computing cell integer coordinates...
+}
+
+int cell_hash (int4 c, int cells)
+{
+  uint hash;                                                                    // Cell hash.
+
+  hash = ((uint)c.x*73856093u)^((uint)c.y*19349663u)^((uint)c.z*83492791u);     // Hashing cell coordinates...
+
+  return (int)(hash & (uint)(cells - 1));                                       // Wrapping hash ("cells" = power of 2)...
+}
+
+int4 span_cell (int4 lo, int4 size, int m)
+{
+  return lo + (int4)(m%size.x, (m/size.x)%size.y, m/(size.x*size.y), 0);       // Computing "m"-th cell of a cell box...
+}
+
+float4 closest_point (float4 p, float4 a, float4 b, float4 c)
+{
+  float3 ab = b.xyz - a.xyz;                                                    // Triangle edge "ab".
+  float3 ac = c.xyz - a.xyz;                                                    // Triangle edge "ac".
+  float3 ap = p.xyz - a.xyz;                                                    // Point relative to "a".
+  float3 bp = p.xyz - b.xyz;                                                    // Point relative to "b".
+  float3 cp = p.xyz - c.xyz;                                                    // Point relative to "c".
+  float  d1 = dot(ab, ap);
+  float  d2 = dot(ac, ap);
+  float  d3 = dot(ab, bp);
+  float  d4 = dot(ac, bp);
+  float  d5 = dot(ab, cp);
+  float  d6 = dot(ac, cp);
+  float  va;
+  float  vb;
+  float  vc;
+  float  v;
+  float  w;
+
+  // VERTEX REGIONS:
+  if ((d1 <= 0.0f) && (d2 <= 0.0f))
+  {
+    return a;                                                                   // Closest to "a"...
+  }
+
+  if ((d3 >= 0.0f) && (d4 <= d3))
+  {
+    return b;                                                                   // Closest to "b"...
+  }
+
+  if ((d6 >= 0.0f) && (d5 <= d6))
+  {
+    return c;                                                                   // Closest to "c"...
+  }
+
+  // EDGE REGIONS:
+  vc = d1*d4 - d3*d2;
+
+  if ((vc <= 0.0f) && (d1 >= 0.0f) && (d3 <= 0.0f))
+  {
+    v = d1/(d1 - d3);
+    return (float4)(a.xyz + v*ab, 1.0f);                                        // Closest to "ab"...
+  }
+
+  vb = d5*d2 - d1*d6;
+
+  if ((vb <= 0.0f) && (d2 >= 0.0f) && (d6 <= 0.0f))
+  {
+    w = d2/(d2 - d6);
+    return (float4)(a.xyz + w*ac, 1.0f);                                        // Closest to "ac"...
+  }
+
+  va = d3*d6 - d5*d4;
+
+  if ((va <= 0.0f) && ((d4 - d3) >= 0.0f) && ((d5 - d6) >= 0.0f))
+  {
+    w = (d4 - d3)/((d4 - d3) + (d5 - d6));
+    return (float4)(b.xyz + w*(c.xyz - b.xyz), 1.0f);                           // Closest to "bc"...
+  }
+
+  // FACE REGION:
+  v = vb/(va + vb + vc);
+  w = vc/(va + vb + vc);
+
+  return (float4)(a.xyz + v*ab + w*ac, 1.0f);                                   // Closest to face...
+}
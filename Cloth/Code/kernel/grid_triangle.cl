@@ -0,0 +1,106 @@
+/// @file
+/// @brief    Spatial hash: triangle binning by bounding box (one work-item per triangle).
+/// @details  A triangle is stored in every cell its bounding box overlaps (once per bin, even when
+///           two of those cells hash to the same bin), so that it is found from any node closer
+///           than one cell to it whatever its size: the cell size needs not grow with the cloth.
+
+__kernel void thekernel(__global int*       color,                              // Color (RGBA8).
+                        __global float4*    position,                           // Position.
+                        __global float4*    velocity,                           // Velocity.
+                        __global float4*    acceleration,                       // Acceleration.
+                        __global float4*    position_int,                       // Position (intermediate).
+                        __global float4*    velocity_int,                       // Velocity (intermediate).
+                        __global float4*    gravity,                            // Gravity.
+                        __global float*     stiffness,                          // Stiffness.
+                        __global float*     resting,                            // Resting distance.
+                        __global float*     friction,                           // Friction.
+                        __global float*     mass,                               // Mass.
+                        __global int*       nearest,                            // Neighbour.
+                        __global int*       offset,                             // Offset.
+                        __global int*       freedom,                            // Freedom flag.
+                        __global float*     dt_simulation,                      // Simulation time step.
+                        __global int*       cell_count,                         // Grid cell node count.
+                        __global int*       cell_node,                          // Grid cell nodes.
+                        __global int*       cell_triangle_count,                // Grid cell triangle count.
+                        __global int*       cell_triangle,                      // Grid cell triangles.
+                        __global int*       triangle,                           // Triangle vertices.
+                        __global float4*    contact_force,                      // Contact force.
+                        __global float*     contact,                            // Contact parameters.
+                        __global int*       grid,                               // Grid parameters.
+                        __global float*     watch_partial,                      // Watchdog partial reductions.
+                        __global float*     watch,                              // Watchdog reductions.
+                        __global int*       watchdog,                           // Watchdog parameters.
+                        __global float4*    checkpoint_position,                // Position (checkpoint).
+                        __global float4*    checkpoint_velocity,                // Velocity (checkpoint).
+                        __global float4*    checkpoint_acceleration,            // Acceleration (checkpoint).
+                        __global int*       bucket_node,                        // Nodes (sorted by degree).
+                        __global int*       bucket,                             // Bucket parameters.
+                        __global int*       patch_index,                        // Patch indices.
+                        __global float*     patch_value,                        // Patch values.
+                        __global int*       patch)                              // Patch parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int t = get_global_id(0);                                            // Global index [#].
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  float         h                 = contact[0];                                 // Grid cell size [m].
+  int           cells             = grid[0];                                    // Number of grid cells [#].
+  int           capacity          = grid[2];                                    // Triangles per cell [#].
+  int           span              = grid[4];                                    // Cells per triangle (maximum) [#].
+  float4        A;                                                              // Vertex "a".
+  float4        B;                                                              // Vertex "b".
+  float4        C;                                                              // Vertex "c".
+  int4          lo;                                                             // Bounding box minimum cell.
+  int4          size;                                                           // Bounding box size [cells].
+  int           n;                                                              // Bounding box cells [#].
+  int           m;                                                              // Bounding box cell index.
+  int           l;                                                              // Bounding box cell index (previous).
+  int           c;                                                              // Cell hash.
+  int           slot;                                                           // Cell slot.
+  bool          seen;                                                           // "true" if bin already used.
+
+  // BINNING TRIANGLE:
+  A = load_state(position_int, triangle[3*t + 0]);                              // Getting vertex "a"...
+  B = load_state(position_int, triangle[3*t + 1]);                              // Getting vertex "b"...
+  C = load_state(position_int, triangle[3*t + 2]);                              // Getting vertex "c"...
+  lo = cell_index(fmin(fmin(A, B), C), h);                                      // Computing bounding box minimum cell...
+  size = cell_index(fmax(fmax(A, B), C), h) - lo + (int4)(1, 1, 1, 1);          // Computing bounding box size...
+  n = size.x*size.y*size.z;                                                     // Computing bounding box cells...
+
+  if (n > span)
+  {
+    atomic_inc(&grid[6]);                                                       // Counting triangle overflow (too large)...
+    return;
+  }
+
+  for (m = 0; m < n; m++)
+  {
+    c = cell_hash(span_cell(lo, size, m), cells);                               // Computing cell hash...
+    seen = false;                                                               // Resetting bin check...
+
+    for (l = 0; (l < m) && !seen; l++)
+    {
+      seen = (cell_hash(span_cell(lo, size, l), cells) == c);                   // Checking bin already used...
+    }
+
+    if (seen)
+    {
+      continue;                                                                 // Skipping bin (triangle already stored)...
+    }
+
+    slot = atomic_inc(&cell_triangle_count[c]);                                 // Reserving cell slot...
+
+    if (slot < capacity)
+    {
+      cell_triangle[c*capacity + slot] = t;                                     // Storing triangle in cell...
+    }
+    else
+    {
+      atomic_inc(&grid[6]);                                                     // Counting triangle overflow...
+    }
+  }
+}
@@ -0,0 +1,14 @@
+/// @file     precision_float.cl
+/// @brief    Intermediate state storage (single precision).
+/// @details  Intermediate positions, velocities and accelerations are stored as they are computed,
+/// one "float4" per node.
+
+float4 load_state (__global float4* state, unsigned int i)
+{
+  return state[i];                                                              // Loading state...
+}
+
+void store_state (float4 value, __global float4* state, unsigned int i)
+{
+  state[i] = value;                                                             // Storing state...
+}
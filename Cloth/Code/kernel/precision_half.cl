@@ -0,0 +1,16 @@
+/// @file     precision_half.cl
+/// @brief    Intermediate state storage (half precision).
+/// @details  Intermediate positions, velocities and accelerations are stored as "half4", two
+/// nodes per "float4" element, halving their memory footprint and traffic. Forces are still
+/// computed and accumulated in single precision: only the stored state is rounded (visualization
+/// grade accuracy). "vload_half"/"vstore_half" do not need the "cl_khr_fp16" extension.
+
+float4 load_state (__global float4* state, unsigned int i)
+{
+  return vload_half4(i, (__global half*)state);                                 // Loading state...
+}
+
+void store_state (float4 value, __global float4* state, unsigned int i)
+{
+  vstore_half4_rte(value, i, (__global half*)state);                            // Storing state (round to nearest even)...
+}
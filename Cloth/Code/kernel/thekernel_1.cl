@@ -1,21 +1,39 @@
 /// @file
 
-__kernel void thekernel(__global float4*    color,                              // Color.
+__kernel void thekernel(__global int*       color,                              // Color (RGBA8).
                         __global float4*    position,                           // Position.
-                        __global float4*    position_int,                       // Position (intermediate).
                         __global float4*    velocity,                           // Velocity.
-                        __global float4*    velocity_int,                       // Velocity (intermediate).
                         __global float4*    acceleration,                       // Acceleration.
+                        __global float4*    position_int,                       // Position (intermediate).
+                        __global float4*    velocity_int,                       // Velocity (intermediate).
                         __global float4*    gravity,                            // Gravity.
                         __global float*     stiffness,                          // Stiffness.
                         __global float*     resting,                            // Resting distance.
                         __global float*     friction,                           // Friction.
                         __global float*     mass,                               // Mass.
-                        __global int*       central,                            // Node.
                         __global int*       nearest,                            // Neighbour.
                         __global int*       offset,                             // Offset.
                         __global int*       freedom,                            // Freedom flag.
-                        __global float*     dt_simulation)                      // Simulation time step.
+                        __global float*     dt_simulation,                      // Simulation time step.
+                        __global int*       cell_count,                         // Grid cell node count.
+                        __global int*       cell_node,                          // Grid cell nodes.
+                        __global int*       cell_triangle_count,                // Grid cell triangle count.
+                        __global int*       cell_triangle,                      // Grid cell triangles.
+                        __global int*       triangle,                           // Triangle vertices.
+                        __global float4*    contact_force,                      // Contact force.
+                        __global float*     contact,                            // Contact parameters.
+                        __global int*       grid,                               // Grid parameters.
+                        __global float*     watch_partial,                      // Watchdog partial reductions.
+                        __global float*     watch,                              // Watchdog reductions.
+                        __global int*       watchdog,                           // Watchdog parameters.
+                        __global float4*    checkpoint_position,                // Position (checkpoint).
+                        __global float4*    checkpoint_velocity,                // Velocity (checkpoint).
+                        __global float4*    checkpoint_acceleration,            // Acceleration (checkpoint).
+                        __global int*       bucket_node,                        // Nodes (sorted by degree).
+                        __global int*       bucket,                             // Bucket parameters.
+                        __global int*       patch_index,                        // Patch indices.
+                        __global float*     patch_value,                        // Patch values.
+                        __global int*       patch)                              // Patch parameters.
 {
   ////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// INDEXES ///////////////////////////////////
@@ -27,8 +45,9 @@ __kernel void thekernel(__global float4*    color,
   ////////////////////////////////////////////////////////////////////////////////
   float4        p                 = position[i];                                // Central node position.
   float4        v                 = velocity[i];                                // Central node velocity.
-  float4        a                 = acceleration[i];                            // Central node acceleration.
+  float4        a                 = load_state(acceleration, i);                // Central node acceleration.
   float4        p_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node position. 
+  float4        v_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node velocity.
   float         fr                = freedom[i];                                 // Central node freedom flag.
   float         dt                = dt_simulation[0];                           // Simulation time step [s].
 
@@ -41,12 +60,13 @@ __kernel void thekernel(__global float4*    color,
   
   // COMPUTING NEW POSITION:
   p_new = p + v*dt + 0.5f*a*dt*dt;                                              // Computing Taylor's approximation...
-  
-  // UPDATING INTERMEDIATE POSITION:
-  position_int[i] = p_new;                                                      // Updating intermediate position...
-  velocity_int[i] = v + a*dt;                                                   // Updating intermediate velocity...
+  v_new = v + a*dt;                                                             // Computing velocity...
 
   // FIXING PROJECTIVE SPACE:
-  position_int[i].w = 1.0f;                                                     // Adjusting projective space...
-  velocity_int[i].w = 1.0f;                                                     // Adjusting projective space...
+  p_new.w = 1.0f;                                                               // Adjusting projective space...
+  v_new.w = 1.0f;                                                               // Adjusting projective space...
+
+  // UPDATING INTERMEDIATE POSITION:
+  store_state(p_new, position_int, i);                                          // Updating intermediate position...
+  store_state(v_new, velocity_int, i);                                          // Updating intermediate velocity...
 }
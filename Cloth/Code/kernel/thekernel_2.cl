@@ -1,40 +1,60 @@
 /// @file
+/// @details  Dispatched once per degree bucket (bucket table: see "include/buckets.hpp").
 
-__kernel void thekernel(__global float4*    color,                              // Color.
+__kernel void thekernel(__global int*       color,                              // Color (RGBA8).
                         __global float4*    position,                           // Position.
-                        __global float4*    position_int,                       // Position (intermediate).
                         __global float4*    velocity,                           // Velocity.
-                        __global float4*    velocity_int,                       // Velocity (intermediate).
                         __global float4*    acceleration,                       // Acceleration.
+                        __global float4*    position_int,                       // Position (intermediate).
+                        __global float4*    velocity_int,                       // Velocity (intermediate).
                         __global float4*    gravity,                            // Gravity.
                         __global float*     stiffness,                          // Stiffness.
                         __global float*     resting,                            // Resting distance.
                         __global float*     friction,                           // Friction.
                         __global float*     mass,                               // Mass.
-                        __global int*       central,                            // Node.
                         __global int*       nearest,                            // Neighbour.
                         __global int*       offset,                             // Offset.
                         __global int*       freedom,                            // Freedom flag.
-                        __global float*     dt_simulation)                      // Simulation time step.
+                        __global float*     dt_simulation,                      // Simulation time step.
+                        __global int*       cell_count,                         // Grid cell node count.
+                        __global int*       cell_node,                          // Grid cell nodes.
+                        __global int*       cell_triangle_count,                // Grid cell triangle count.
+                        __global int*       cell_triangle,                      // Grid cell triangles.
+                        __global int*       triangle,                           // Triangle vertices.
+                        __global float4*    contact_force,                      // Contact force.
+                        __global float*     contact,                            // Contact parameters.
+                        __global int*       grid,                               // Grid parameters.
+                        __global float*     watch_partial,                      // Watchdog partial reductions.
+                        __global float*     watch,                              // Watchdog reductions.
+                        __global int*       watchdog,                           // Watchdog parameters.
+                        __global float4*    checkpoint_position,                // Position (checkpoint).
+                        __global float4*    checkpoint_velocity,                // Velocity (checkpoint).
+                        __global float4*    checkpoint_acceleration,            // Acceleration (checkpoint).
+                        __global int*       bucket_node,                        // Nodes (sorted by degree).
+                        __global int*       bucket,                             // Bucket parameters.
+                        __global int*       patch_index,                        // Patch indices.
+                        __global float*     patch_value,                        // Patch values.
+                        __global int*       patch)                              // Patch parameters.
 {
   ////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// INDEXES ///////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
-  unsigned int i = get_global_id(0);                                            // Global index [#].
+  unsigned int q = get_global_id(0);                                            // Global index [#].
+  int          b = bucket[0];                                                   // Bucket table entry (negative = node order).
+  unsigned int i = (b < 0) ? q : bucket_node[bucket[3 + b] + q];                // Node index (degree bucket order) [#].
   unsigned int j = 0;                                                           // Neighbour stride index.
   unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
   unsigned int j_max = offset[i];                                               // Neighbour stride maximum index.
   unsigned int k = 0;                                                           // Neighbour tuple index.
-  unsigned int n = central[j_max - 1];                                          // Node index.
+  unsigned int n = i;                                                           // Node index (the row of its links).
 
   ////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// CELL VARIABLES //////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
-  float4        c;                                                              // Central node color.
   float4        v                 = velocity[n];                                // Central node velocity.
-  float4        a                 = acceleration[n];                            // Central node acceleration.
-  float4        p_int             = position_int[n];                            // Central node position (intermediate).
-  float4        v_int             = velocity_int[n];                            // Central node velocity (intermediate).
+  float4        a                 = load_state(acceleration, n);                // Central node acceleration.
+  float4        p_int             = load_state(position_int, n);                // Central node position (intermediate).
+  float4        v_int             = load_state(velocity_int, n);                // Central node velocity (intermediate).
   float4        p_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node position (new).
   float4        v_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node velocity (new).
   float4        a_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node acceleration (new).
@@ -48,6 +68,7 @@ __kernel void thekernel(__global float4*    color,
   float4        Fv                = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node viscous force.
   float4        Fv_est            = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node viscous force (estimation).
   float4        Fg                = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node gravitational force. 
+  float4        Fc                = contact_force[n];                           // Central node contact force.
   float4        F                 = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node total force.
   float4        F_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node total force (new).
   float4        neighbour         = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Neighbour node position.
@@ -82,7 +103,7 @@ __kernel void thekernel(__global float4*    color,
   for (j = j_min; j < j_max; j++)
   {
     k = nearest[j];                                                             // Computing neighbour index...
-    neighbour = position_int[k];                                                // Getting neighbour position...
+    neighbour = load_state(position_int, k);                                    // Getting neighbour position...
     link = neighbour - p_int;                                                   // Getting neighbour link vector...
     R = resting[j];                                                             // Getting neighbour link resting length...
     K = stiffness[j];                                                           // Getting neighbour link stiffness...
@@ -91,9 +112,9 @@ __kernel void thekernel(__global float4*    color,
     D = S*normalize(link);                                                      // Computing neighbour link displacement...
     Fe += K*D;                                                                  // Building up elastic force on central node...
 
-    if (color[j].w != 0.1f)
+    if (((uint)color[j] >> 24) == 255)
     {
-      color[j].xyz = colormap(0.7f*(1.0f + S/R));                               // Setting color...
+      color[j] = pack_color(colormap(0.7f*(1.0f + S/R)), 255);                  // Setting color (opaque links only)...
     }
     
     if(L > 0.0f)
@@ -110,7 +131,7 @@ __kernel void thekernel(__global float4*    color,
   // COMPUTING TOTAL FORCE:
   Fg = m*g;                                                                     // Computing node gravitational force...
   Fv = -B*v_int;                                                                // Computing node viscous force...
-  F = Fg + Fe + Fv;                                                             // Computing total node force...
+  F = Fg + Fe + Fv + Fc;                                                        // Computing total node force...
 
   // COMPUTING NEW ACCELERATION ESTIMATION:
   a_est  = F/m;                                                                 // Computing acceleration...
@@ -122,7 +143,7 @@ __kernel void thekernel(__global float4*    color,
   Fv_est = -B*v_est;                                                            // Computing node viscous force...
 
   // COMPUTING NEW TOTAL FORCE:
-  F_new = Fg + Fe + Fv_est;                                                     // Computing total node force...
+  F_new = Fg + Fe + Fv_est + Fc;                                                // Computing total node force...
 
   // COMPUTING NEW ACCELERATION:
   a_new = F_new/m;                                                              // Computing acceleration...
@@ -142,12 +163,28 @@ __kernel void thekernel(__global float4*    color,
     v_new = (float4)(0.0f, 0.0f, 0.0f, 1.0f);                                   // Constraining velocity...
   }
 
+  // COMPUTING NEW POSITION (from the unrounded state):
+  p_new = position[n];                                                          // Getting position...
+
+  if (fr != 0)
+  {
+    p_new += v*dt + 0.5f*a*dt*dt;                                               // Computing Taylor's approximation...
+  }
+
   // FIXING PROJECTIVE SPACE:
+  p_new.w = 1.0f;                                                               // Adjusting projective space...
   v_new.w = 1.0f;                                                               // Adjusting projective space...
   a_new.w = 1.0f;                                                               // Adjusting projective space...
 
   // UPDATING KINEMATICS:
-  position[n] = p_int;                                                          // Updating position [m]...
+  position[n] = p_new;                                                          // Updating position [m]...
   velocity[n] = v_new;                                                          // Updating velocity [m/s]...
-  acceleration[n] = a_new;                                                      // Updating acceleration [m/s^2]...
+  store_state(a_new, acceleration, n);                                          // Updating acceleration [m/s^2]...
+
+  // MOVING TO THE NEXT BUCKET (last work-item of the dispatch):
+  if ((b >= 0) && (atomic_inc(&bucket[1]) == (int)(get_global_size(0) - 1)))
+  {
+    bucket[1] = 0;                                                              // Resetting finished work-items...
+    bucket[0] = (b + 1) % bucket[2];                                            // Moving to next entry (wrapping to the first)...
+  }
 }
@@ -2,7 +2,7 @@
 /// @author   Erik ZORZIN
 /// @date     26MAR2021
 /// @brief    Some useful functions.
-/// @details  Colormap.
+/// @details  Colormap, RGBA8 color packing.
 
 float3 colormap (float intensity)
 {
@@ -283,3 +283,12 @@ float3 colormap (float intensity)
     return (float3)(turbo_colormap[i]);
 }
 
+int pack_color (float3 color, int alpha)
+{
+    uint3 rgb;
+
+    // Packing "r", "g", "b" and "alpha" bytes (from the lowest), as "unpackUnorm4x8" in GLSL:
+    rgb = convert_uint3_sat_rte(255.0f*color);
+
+    return (int)(rgb.x | (rgb.y << 8) | (rgb.z << 16) | ((uint)alpha << 24));
+}
@@ -0,0 +1,24 @@
+/// @file     watch.cl
+/// @brief    Watchdog reductions.
+/// @details  Serial reduction in private memory of the watchdog quantities: kinetic energy,
+/// elastic energy and momentum (summed), maximum strain and non-finite flag (maximum). No work-group
+/// size or local memory is required, so the kernels run with any local size chosen by the runtime.
+/// The host "WATCH_SIZE" must match the one defined here.
+
+#define WATCH_SIZE  7                                                           // Number of watched quantities [#].
+#define WATCH_MAX   5                                                           // First quantity reduced by maximum.
+
+void watch_merge (float* w, float* q)
+{
+  unsigned int k;                                                               // Quantity index.
+
+  for (k = 0; k < WATCH_MAX; k++)
+  {
+    w[k] += q[k];                                                               // Summing...
+  }
+
+  for (k = WATCH_MAX; k < WATCH_SIZE; k++)
+  {
+    w[k] = fmax(w[k], q[k]);                                                    // Maximizing...
+  }
+}
@@ -0,0 +1,105 @@
+/// @file
+/// @brief    Watchdog: partial reductions (one work-item per chunk of "WATCH_CHUNK" nodes).
+/// @details  Work-item "g" reduces the nodes g, g + chunks, g + 2*chunks, ... (so that neighbouring
+/// work-items read neighbouring nodes) into its partial. Each link appears in the neighbour lists of
+/// both its nodes, hence each node accounts for half of the elastic energy of its links.
+
+__kernel
+void thekernel(__global int*       color,                                       // Color (RGBA8).
+               __global float4*    position,                                    // Position.
+               __global float4*    velocity,                                    // Velocity.
+               __global float4*    acceleration,                                // Acceleration.
+               __global float4*    position_int,                                // Position (intermediate).
+               __global float4*    velocity_int,                                // Velocity (intermediate).
+               __global float4*    gravity,                                     // Gravity.
+               __global float*     stiffness,                                   // Stiffness.
+               __global float*     resting,                                     // Resting distance.
+               __global float*     friction,                                    // Friction.
+               __global float*     mass,                                        // Mass.
+               __global int*       nearest,                                     // Neighbour.
+               __global int*       offset,                                      // Offset.
+               __global int*       freedom,                                     // Freedom flag.
+               __global float*     dt_simulation,                               // Simulation time step.
+               __global int*       cell_count,                                  // Grid cell node count.
+               __global int*       cell_node,                                   // Grid cell nodes.
+               __global int*       cell_triangle_count,                         // Grid cell triangle count.
+               __global int*       cell_triangle,                               // Grid cell triangles.
+               __global int*       triangle,                                    // Triangle vertices.
+               __global float4*    contact_force,                               // Contact force.
+               __global float*     contact,                                     // Contact parameters.
+               __global int*       grid,                                        // Grid parameters.
+               __global float*     watch_partial,                               // Watchdog partial reductions.
+               __global float*     watch,                                       // Watchdog reductions.
+               __global int*       watchdog,                                    // Watchdog parameters.
+               __global float4*    checkpoint_position,                         // Position (checkpoint).
+               __global float4*    checkpoint_velocity,                         // Velocity (checkpoint).
+               __global float4*    checkpoint_acceleration,                     // Acceleration (checkpoint).
+               __global int*       bucket_node,                                 // Nodes (sorted by degree).
+               __global int*       bucket,                                      // Bucket parameters.
+               __global int*       patch_index,                                 // Patch indices.
+               __global float*     patch_value,                                 // Patch values.
+               __global int*       patch)                                       // Patch parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int g = get_global_id(0);                                            // Chunk index [#].
+  unsigned int i = 0;                                                           // Node index [#].
+  unsigned int j = 0;                                                           // Neighbour stride index.
+  unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
+  unsigned int j_max = 0;                                                       // Neighbour stride maximum index.
+  unsigned int k = 0;                                                           // Quantity index.
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  float         w[WATCH_SIZE];                                                  // Chunk quantities.
+  float         q[WATCH_SIZE];                                                  // Node quantities.
+  float4        p;                                                              // Central node position.
+  float4        v;                                                              // Central node velocity.
+  float         m;                                                              // Central node mass.
+  float         d;                                                              // Link elongation [m].
+  int           nodes             = watchdog[0];                                // Number of nodes [#].
+  int           chunks            = watchdog[1];                                // Number of chunks [#].
+
+  for (k = 0; k < WATCH_SIZE; k++)
+  {
+    w[k] = 0.0f;                                                                // Initializing quantity...
+  }
+
+  // REDUCING NODE QUANTITIES:
+  for (i = g; (int)i < nodes; i += chunks)
+  {
+    p    = position[i];                                                         // Getting position...
+    v    = velocity[i];                                                         // Getting velocity...
+    m    = mass[i];                                                             // Getting mass...
+    q[0] = 0.5f*m*dot(v.xyz, v.xyz);                                            // Computing kinetic energy...
+    q[1] = 0.0f;                                                                // Initializing elastic energy...
+    q[2] = m*v.x;                                                               // Computing momentum...
+    q[3] = m*v.y;                                                               // Computing momentum...
+    q[4] = m*v.z;                                                               // Computing momentum...
+    q[5] = 0.0f;                                                                // Initializing maximum strain...
+    q[6] = 0.0f;                                                                // Initializing non-finite flag...
+    j_min = (i == 0) ? 0 : offset[i - 1];                                       // Setting minimum neighbour stride index...
+    j_max = offset[i];                                                          // Setting maximum neighbour stride index...
+
+    for (j = j_min; j < j_max; j++)
+    {
+      d = length(position[nearest[j]].xyz - p.xyz) - resting[j];                // Computing link elongation...
+      q[1] += 0.25f*stiffness[j]*d*d;                                           // Accumulating elastic energy (half link)...
+      q[5] = fmax(q[5], fabs(d)/resting[j]);                                    // Updating maximum strain...
+    }
+
+    if (any(!isfinite(p.xyz)) || any(!isfinite(v.xyz)) || !isfinite(q[1]))
+    {
+      q[6] = 1.0f;                                                              // Flagging non-finite state...
+    }
+
+    watch_merge(w, q);                                                          // Merging node quantities...
+  }
+
+  for (k = 0; k < WATCH_SIZE; k++)
+  {
+    watch_partial[g*WATCH_SIZE + k] = w[k];                                     // Storing chunk quantity...
+  }
+}
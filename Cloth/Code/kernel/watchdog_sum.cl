@@ -0,0 +1,73 @@
+/// @file
+/// @brief    Watchdog: final reduction of the chunk partials (a single work-item).
+
+__kernel
+void thekernel(__global int*       color,                                       // Color (RGBA8).
+               __global float4*    position,                                    // Position.
+               __global float4*    velocity,                                    // Velocity.
+               __global float4*    acceleration,                                // Acceleration.
+               __global float4*    position_int,                                // Position (intermediate).
+               __global float4*    velocity_int,                                // Velocity (intermediate).
+               __global float4*    gravity,                                     // Gravity.
+               __global float*     stiffness,                                   // Stiffness.
+               __global float*     resting,                                     // Resting distance.
+               __global float*     friction,                                    // Friction.
+               __global float*     mass,                                        // Mass.
+               __global int*       nearest,                                     // Neighbour.
+               __global int*       offset,                                      // Offset.
+               __global int*       freedom,                                     // Freedom flag.
+               __global float*     dt_simulation,                               // Simulation time step.
+               __global int*       cell_count,                                  // Grid cell node count.
+               __global int*       cell_node,                                   // Grid cell nodes.
+               __global int*       cell_triangle_count,                         // Grid cell triangle count.
+               __global int*       cell_triangle,                               // Grid cell triangles.
+               __global int*       triangle,                                    // Triangle vertices.
+               __global float4*    contact_force,                               // Contact force.
+               __global float*     contact,                                     // Contact parameters.
+               __global int*       grid,                                        // Grid parameters.
+               __global float*     watch_partial,                               // Watchdog partial reductions.
+               __global float*     watch,                                       // Watchdog reductions.
+               __global int*       watchdog,                                    // Watchdog parameters.
+               __global float4*    checkpoint_position,                         // Position (checkpoint).
+               __global float4*    checkpoint_velocity,                         // Velocity (checkpoint).
+               __global float4*    checkpoint_acceleration,                     // Acceleration (checkpoint).
+               __global int*       bucket_node,                                 // Nodes (sorted by degree).
+               __global int*       bucket,                                      // Bucket parameters.
+               __global int*       patch_index,                                 // Patch indices.
+               __global float*     patch_value,                                 // Patch values.
+               __global int*       patch)                                       // Patch parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int g = 0;                                                           // Chunk index [#].
+  unsigned int k = 0;                                                           // Quantity index.
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  float         w[WATCH_SIZE];                                                  // Total quantities.
+  float         q[WATCH_SIZE];                                                  // Chunk quantities.
+  int           chunks            = watchdog[1];                                // Number of partials [#].
+
+  for (k = 0; k < WATCH_SIZE; k++)
+  {
+    w[k] = 0.0f;                                                                // Initializing quantity...
+  }
+
+  // REDUCING PARTIALS (in chunk order, hence deterministically):
+  for (g = 0; (int)g < chunks; g++)
+  {
+    for (k = 0; k < WATCH_SIZE; k++)
+    {
+      q[k] = watch_partial[g*WATCH_SIZE + k];                                   // Getting chunk quantity...
+    }
+
+    watch_merge(w, q);                                                          // Merging chunk quantities...
+  }
+
+  for (k = 0; k < WATCH_SIZE; k++)
+  {
+    watch[k] = w[k];                                                            // Storing quantity...
+  }
+}
@@ -1,14 +1,16 @@
-/// @file
-#version 460 core
-
-uniform mat4 V_mat;                                                             // View matrix.
-uniform mat4 P_mat;                                                             // Projection matrix.
-uniform float size_x;                                                           // Framebuffer size_x.
-uniform float size_y;                                                           // Framebuffer size_y.
-uniform float AR;                                                               // Framebuffer aspect ratio.
-
-/// @function
-void main(void)
-{        
-  // Doing nothing!
+/// @file
+/// Neutrino's own program, built with no points: it only holds the camera uniforms (see the geometry
+/// shader); the links are drawn by include/shader/link_*.
+#version 460 core
+
+uniform mat4 V_mat;                                                             // View matrix.
+uniform mat4 P_mat;                                                             // Projection matrix.
+uniform float size_x;                                                           // Framebuffer size_x.
+uniform float size_y;                                                           // Framebuffer size_y.
+uniform float AR;                                                               // Framebuffer aspect ratio.
+
+/// @function
+void main(void)
+{        
+  // Doing nothing!
 }
\ No newline at end of file
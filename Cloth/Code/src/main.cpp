@@ -1,6 +1,6 @@
 /// @file
 
-#define INTEROP       true                                                                          // "true" = use OpenGL-OpenCL interoperability.
+#define INTEROP       false                                                                         // "false" = plain OpenCL buffers (the renderer draws host snapshots).
 #define SX            800                                                                           // Window x-size [px].
 #define SY            600                                                                           // Window y-size [px].
 #define NAME          "Neutrino - Cloth"                                                            // Window name.
@@ -21,15 +21,51 @@
 #define DS            0.05                                                                          // Cloth elementary cell side.
 #define EPSILON       0.01                                                                          // Tolerance for cell detection.
 #define CELL_VERTICES 4                                                                             // Number of vertices per elementary cell.
+#define NODE_CAP      8                                                                             // Grid cell node capacity [#].
+#define TRIANGLE_CAP  32                                                                            // Grid cell triangle capacity [#].
+#define TRIANGLE_SPAN 64                                                                            // Grid cells per triangle (maximum) [#].
+#define OBSTACLE_X    0.0f                                                                          // Obstacle center "x" coordinate [m].
+#define OBSTACLE_Y    0.0f                                                                          // Obstacle center "y" coordinate [m].
+#define OBSTACLE_Z    -0.5f                                                                         // Obstacle center "z" coordinate [m].
+#define OBSTACLE_R    0.4f                                                                          // Obstacle radius [m].
+#define PROFILE_STEPS 1000                                                                          // Profiler report interval [steps].
+#define CPU_BLOCK     256                                                                           // CPU solver block size [#].
+#define CHECK_STEPS   100                                                                           // CPU/GPU validation length [steps].
+#define HALF_STATE    false                                                                         // "true" = OpenCL intermediate state stored in half precision.
+#define TOLERANCE     (HALF_STATE ? 1.0e-2f : 1.0e-3f)                                              // CPU/GPU validation tolerance [m].
+#define LINK_PIXELS   1.0f                                                                          // Link LOD threshold (projected length) [px].
+#define WATCH_STEPS   100                                                                           // Watchdog interval [steps].
+#define WATCH_CHUNK   64                                                                            // Watchdog nodes per work-item [#].
+#define WATCH_SIZE    7                                                                             // Watchdog quantities (as in "watch.cl") [#].
+#define WATCH_STRAIN  1.0f                                                                          // Watchdog divergence threshold (maximum link strain).
+#define WATCH_LOG     "watchdog.csv"                                                                // Watchdog time series.
+#define SIMD_WIDTH    32                                                                            // SIMD width (degree bucket efficiency model) [#].
+#define PATCH_MAX     1024                                                                          // Patch capacity (per scatter dispatch) [#].
+#define PATCH_TARGETS 2                                                                             // Patch targets (as in "patch.cl") [#].
+#define PATCH_FREE    0                                                                             // Patch target: freedom flags (as in "patch.cl").
+#define PATCH_STIFF   1                                                                             // Patch target: link stiffness (as in "patch.cl").
+#define PATCH_RADIUS  0.2f                                                                          // Patch region radius (above the obstacle) [m].
+#define PATCH_GAIN    10.0f                                                                         // Patch region stiffness gain.
+#define RECORD_STEPS  10                                                                            // Recording interval [steps].
+#define RECORD_SLOTS  3                                                                             // Recording pixel buffer ring size [#].
+#define RECORD_QUEUE  8                                                                             // Recording writer queue capacity [frames].
+#define RECORD_PREFIX "cloth_"                                                                      // Recording image file prefix.
+#define FRAME_STEPS   10                                                                            // Simulation steps per frame (input capture and replay) [steps].
+#define INPUT_LOG     "input.log"                                                                   // Per-frame input log.
+#define TIMING_LOG    "frames.csv"                                                                  // Per-frame timing log.
+#define SWEEP_STEPS   1000                                                                          // Simulation steps per sweep point [steps].
+#define SWEEP_LOG     "sweep.csv"                                                                   // Sweep results table.
 
 #ifdef __linux__
   #define SHADER_HOME "../../Cloth/Code/shader/"                                                    // Linux OpenGL shaders directory.
+  #define LINK_HOME   "../../include/shader/"                                                       // Linux OpenGL link shaders directory (shared).
   #define KERNEL_HOME "../../Cloth/Code/kernel/"                                                    // Linux OpenCL kernels directory.
   #define GMSH_HOME   "../../Cloth/Code/mesh/"                                                      // Linux GMSH mesh directory.
 #endif
 
 #ifdef WIN32
   #define SHADER_HOME "..\\..\\Cloth\\Code\\shader\\"                                               // Windows OpenGL shaders directory.
+  #define LINK_HOME   "..\\..\\include\\shader\\"                                                   // Windows OpenGL link shaders directory (shared).
   #define KERNEL_HOME "..\\..\\Cloth\\Code\\kernel\\"                                               // Windows OpenCL kernels directory.
   #define GMSH_HOME   "..\\..\\Cloth\\Code\\mesh\\"                                                 // Linux GMSH mesh directory.
 #endif
@@ -37,15 +73,62 @@
 #define SHADER_VERT   "voxel_vertex.vert"                                                           // OpenGL vertex shader.
 #define SHADER_GEOM   "voxel_geometry.geom"                                                         // OpenGL geometry shader.
 #define SHADER_FRAG   "voxel_fragment.frag"                                                         // OpenGL fragment shader.
+#define SHADER_COMP   "link_transform.comp"                                                         // OpenGL link node transform shader.
+#define SHADER_CULL   "link_cull.comp"                                                              // OpenGL link culling shader.
+#define SHADER_LINK   "link_vertex.vert"                                                            // OpenGL link vertex shader.
 #define KERNEL_1      "thekernel_1.cl"                                                              // OpenCL kernel source.
 #define KERNEL_2      "thekernel_2.cl"                                                              // OpenCL kernel source.
+#define KERNEL_3      "grid_clear.cl"                                                               // OpenCL kernel source.
+#define KERNEL_4      "grid_node.cl"                                                                // OpenCL kernel source.
+#define KERNEL_5      "grid_triangle.cl"                                                            // OpenCL kernel source.
+#define KERNEL_6      "contact.cl"                                                                  // OpenCL kernel source.
+#define KERNEL_7      "watchdog.cl"                                                                 // OpenCL kernel source.
+#define KERNEL_8      "watchdog_sum.cl"                                                             // OpenCL kernel source.
+#define KERNEL_9      "checkpoint.cl"                                                               // OpenCL kernel source.
+#define KERNEL_10     "rollback.cl"                                                                 // OpenCL kernel source.
+#define KERNEL_11     "patch.cl"                                                                    // OpenCL kernel source.
 #define UTILITIES     "utilities.cl"                                                                // OpenCL utilities source.
+#define GRID          "grid.cl"                                                                     // OpenCL spatial hash source.
+#define WATCH         "watch.cl"                                                                    // OpenCL watchdog reduction source.
+#define PRECISION     (HALF_STATE ? "precision_half.cl" : "precision_float.cl")                     // OpenCL state storage source.
+#define PRECISION_ALT (HALF_STATE ? "precision_float.cl" : "precision_half.cl")                     // OpenCL state storage source (compared).
 #define MESH          "Square_quadrangles.msh"                                                      // GMSH mesh.
 
+#define DRAW_COLOR    32                                                                            // Link color SSBO binding (rendering).
+#define DRAW_POSITION 33                                                                            // Node position SSBO binding (rendering).
+#define DRAW_OFFSET   34                                                                            // Neighbour offset SSBO binding (rendering).
+#define DRAW_NEAREST  35                                                                            // Neighbour node SSBO binding (rendering).
+#define DRAW_CLIP     36                                                                            // Link renderer SSBO bindings (36...38, rendering).
+
 // INCLUDES:
 #include "nu.hpp"                                                                                   // Neutrino's header file.
+#include "triple_buffer.hpp"                                                                        // Lock-free triple buffer.
+#include "storage.hpp"                                                                              // OpenGL storage buffer.
+#include "cpu_solver.hpp"                                                                           // CPU reference solver.
+#include "half.hpp"                                                                                 // Half precision state packing.
+#include "buckets.hpp"                                                                              // Degree buckets.
+#include "patches.hpp"                                                                              // Sparse parameter patches.
+#include "recorder.hpp"                                                                             // Offscreen frame recorder.
+#include "input_log.hpp"                                                                            // Per-frame input log.
+#include "config.hpp"                                                                               // Runtime configuration.
+#include "link_renderer.hpp"                                                                        // Instanced link renderer.
+#include <thread>                                                                                   // Standard threads.
+#include <atomic>                                                                                   // Standard atomics.
+#include <mutex>                                                                                    // Standard mutexes.
+#include <condition_variable>                                                                       // Standard condition variables.
+#include <chrono>                                                                                   // Standard clocks.
+#include <cstring>                                                                                  // Standard C strings.
+#include <fstream>                                                                                  // Standard file streams.
+
+// SNAPSHOT:
+typedef struct
+{
+  std::vector<int>                 color;                                                           // Link color (RGBA8).
+  std::vector<nu_float4_structure> position;                                                        // Node position [m].
+  size_t                           step;                                                            // Simulation step [#].
+} snapshot;
 
-int main ()
+int main (int argc, char** argv)
 {
   // INDICES:
   size_t                           i;                                                               // Index [#].
@@ -76,12 +159,44 @@ int main ()
                                                                     PANZ
                                                                    );                               // OpenGL context.
   nu::shader*                      S              = new nu::shader ();                              // OpenGL shader program.
+  examples::storage*               draw_color     = new examples::storage (DRAW_COLOR);             // Link color (rendering).
+  examples::storage*               draw_position  = new examples::storage (DRAW_POSITION);          // Node position (rendering).
+  examples::storage*               draw_offset    = new examples::storage (DRAW_OFFSET);            // Neighbour offsets (rendering).
+  examples::storage*               draw_nearest   = new examples::storage (DRAW_NEAREST);           // Neighbour nodes (rendering).
+  examples::link_renderer*         links;                                                           // Link renderer (rendering).
+  examples::recorder*              video          = nullptr;                                        // Offscreen frame recorder (rendering).
+  bool                             record         = false;                                          // "true" = record the frames to disk.
+  bool                             fresh;                                                           // "true" = new snapshot taken.
+
+  // INPUT CAPTURE AND REPLAY:
+  bool                             capture        = false;                                          // "true" = log the input of every frame.
+  bool                             replay         = false;                                          // "true" = drive the frames from the input log.
+  bool                             lockstep       = false;                                          // "true" = FRAME_STEPS simulation steps per frame.
+  examples::input_log*             inputs         = nullptr;                                        // Per-frame input log.
+  examples::input                  now;                                                             // Frame input.
+  std::ofstream                    timing_log;                                                      // Per-frame timing log.
+  size_t                           frame          = 0;                                              // Frame [#].
+  double                           frame_total    = 0.0;                                            // Total frame time [us].
 
   // OPENCL:
-  nu::opencl*                      cl             = new nu::opencl (NU_GPU);                        // OpenCL context.
+  nu::opencl*                      cl             = nullptr;                                        // OpenCL context (GPU backend).
   nu::kernel*                      K1             = new nu::kernel ();                              // OpenCL kernel array.
   nu::kernel*                      K2             = new nu::kernel ();                              // OpenCL kernel array.
-  nu::float4*                      color          = new nu::float4 (0);                             // Color [].
+  nu::kernel*                      K3             = new nu::kernel ();                              // OpenCL kernel array (grid clear).
+  nu::kernel*                      K4             = new nu::kernel ();                              // OpenCL kernel array (grid nodes).
+  nu::kernel*                      K5             = new nu::kernel ();                              // OpenCL kernel array (grid triangles).
+  nu::kernel*                      K6             = new nu::kernel ();                              // OpenCL kernel array (contact).
+  nu::kernel*                      K7             = new nu::kernel ();                              // OpenCL kernel array (watchdog groups).
+  nu::kernel*                      K8             = new nu::kernel ();                              // OpenCL kernel array (watchdog sum).
+  nu::kernel*                      K9             = new nu::kernel ();                              // OpenCL kernel array (checkpoint).
+  nu::kernel*                      K10            = new nu::kernel ();                              // OpenCL kernel array (rollback).
+  nu::kernel*                      K11            = new nu::kernel ();                              // OpenCL kernel array (patch scatter).
+  nu::kernel*                      K1_alt         = new nu::kernel ();                              // OpenCL kernel array (predictor, compared precision).
+  nu::kernel*                      K2_alt         = new nu::kernel ();                              // OpenCL kernel array (corrector, compared precision).
+  nu::kernel*                      K4_alt         = new nu::kernel ();                              // OpenCL kernel array (grid nodes, compared precision).
+  nu::kernel*                      K5_alt         = new nu::kernel ();                              // OpenCL kernel array (grid triangles, compared precision).
+  nu::kernel*                      K6_alt         = new nu::kernel ();                              // OpenCL kernel array (contact, compared precision).
+  nu::int1*                        color          = new nu::int1 (0);                               // Color (RGBA8).
   nu::float4*                      position       = new nu::float4 (1);                             // Position [m].
   nu::float4*                      velocity       = new nu::float4 (2);                             // Velocity [m/s].
   nu::float4*                      acceleration   = new nu::float4 (3);                             // Acceleration [m/s^2].
@@ -92,20 +207,33 @@ int main ()
   nu::float1*                      resting        = new nu::float1 (8);                             // Resting.
   nu::float1*                      friction       = new nu::float1 (9);                             // Friction.
   nu::float1*                      mass           = new nu::float1 (10);                            // Mass [kg].
-  nu::int1*                        central        = new nu::int1 (11);                              // Central nodes.
-  nu::int1*                        neighbour      = new nu::int1 (12);                              // Neighbour.
-  nu::int1*                        offset         = new nu::int1 (13);                              // Offset.
-  nu::int1*                        freedom        = new nu::int1 (14);                              // Freedom.
-  nu::float1*                      dt             = new nu::float1 (15);                            // Time step [s].
+  nu::int1*                        neighbour      = new nu::int1 (11);                              // Neighbour.
+  nu::int1*                        offset         = new nu::int1 (12);                              // Offset.
+  nu::int1*                        freedom        = new nu::int1 (13);                              // Freedom.
+  nu::float1*                      dt             = new nu::float1 (14);                            // Time step [s].
+  nu::int1*                        cell_count     = new nu::int1 (15);                              // Grid cell node count.
+  nu::int1*                        cell_node      = new nu::int1 (16);                              // Grid cell nodes.
+  nu::int1*                        cell_tri_count = new nu::int1 (17);                              // Grid cell triangle count.
+  nu::int1*                        cell_triangle  = new nu::int1 (18);                              // Grid cell triangles.
+  nu::int1*                        triangle       = new nu::int1 (19);                              // Triangle vertices.
+  nu::float4*                      contact_force  = new nu::float4 (20);                            // Contact force [N].
+  nu::float1*                      contact        = new nu::float1 (21);                            // Contact parameters.
+  nu::int1*                        grid           = new nu::int1 (22);                              // Grid parameters.
+  nu::float1*                      watch_partial  = new nu::float1 (23);                            // Watchdog partial reductions.
+  nu::float1*                      watch          = new nu::float1 (24);                            // Watchdog reductions.
+  nu::int1*                        watchdog       = new nu::int1 (25);                              // Watchdog parameters.
+  nu::float4*                      ckpt_position  = new nu::float4 (26);                            // Position (checkpoint) [m].
+  nu::float4*                      ckpt_velocity  = new nu::float4 (27);                            // Velocity (checkpoint) [m/s].
+  nu::float4*                      ckpt_accel     = new nu::float4 (28);                            // Acceleration (checkpoint) [m/s^2].
+  nu::int1*                        bucket_node    = new nu::int1 (29);                              // Nodes (sorted by degree).
+  nu::int1*                        bucket         = new nu::int1 (30);                              // Bucket parameters.
+  nu::int1*                        patch_index    = new nu::int1 (31);                              // Patch indices.
+  nu::float1*                      patch_value    = new nu::float1 (32);                            // Patch values.
+  nu::int1*                        patch          = new nu::int1 (33);                              // Patch parameters.
+  std::vector<nu::kernel*>         K2_bucket;                                                       // OpenCL kernel arrays (corrector, one per degree bucket).
 
   // MESH:
-  nu::mesh*                        cloth          = new nu::mesh (
-                                                                  std::string (
-                                                                               GMSH_HOME
-                                                                              ) + std::string (
-                                                                                               MESH
-                                                                                              )
-                                                                 );                                 // Mesh cloth.
+  nu::mesh*                        cloth;                                                           // Mesh cloth.
   size_t                           nodes;                                                           // Number of nodes.
   size_t                           elements;                                                        // Number of elements.
   size_t                           groups;                                                          // Number of groups.
@@ -113,6 +241,7 @@ int main ()
   std::vector<size_t>              side_x;                                                          // Nodes on "x" side.
   std::vector<size_t>              side_y;                                                          // Nodes on "y" side.
   std::vector<GLint>               border;                                                          // Nodes on border.
+  examples::buckets*               node_buckets;                                                    // Degree buckets.
   size_t                           side_x_nodes;                                                    // Number of nodes in "x" direction [#].
   size_t                           side_y_nodes;                                                    // Number of nodes in "x" direction [#].
   size_t                           border_nodes;                                                    // Number of border nodes.
@@ -122,6 +251,10 @@ int main ()
   float                            y_max = +1.0f;                                                   // "y_max" spatial boundary [m].
   float                            dx;                                                              // x-axis mesh spatial size [m].
   float                            dy;                                                              // y-axis mesh spatial size [m].
+  size_t                           triangles;                                                       // Number of triangles.
+  size_t                           cells;                                                           // Number of grid cells.
+  float                            radius;                                                          // Contact radius [m].
+  float                            cell_size;                                                       // Grid cell size [m].
 
   // SIMULATION PARAMETERS:
   float                            h     = 0.01f;                                                   // Cloth's thickness [m].
@@ -137,12 +270,211 @@ int main ()
   float                            dt_critical;                                                     // Critical time step [s].
   float                            dt_simulation;                                                   // Simulation time step [s].
 
+  // CONFIGURATION:
+  examples::config*                settings       = new examples::config ();                        // Runtime configuration.
+  std::vector<std::string>         overrides;                                                       // Parameter overrides ("--set").
+  std::vector<std::string>         sweeps;                                                          // Sweep axes ("--sweep").
+  std::string                      mesh_file;                                                       // GMSH mesh.
+  int                              surface_tag;                                                     // Surface tag.
+  float                            ds;                                                              // Cloth elementary cell side.
+  float                            epsilon;                                                         // Tolerance for cell detection.
+  size_t                           points;                                                          // Sweep points [#].
+  size_t                           sweep_steps;                                                     // Simulation steps per sweep point [steps].
+  size_t                           uploads;                                                         // Parameter buffers written (sweep point) [#].
+  double                           step_time;                                                       // Step time (sweep point) [us].
+  std::string                      sweep_point;                                                     // Sweep point parameters.
+  std::ofstream                    sweep_log;                                                       // Sweep results table.
+
+  // BACKENDS:
+  bool                             cpu            = false;                                          // "true" = run on the CPU solver.
+  bool                             validate       = false;                                          // "true" = check CPU against GPU.
+  bool                             report         = false;                                          // "true" = compare half and float state.
+  bool                             unsorted       = false;                                          // "true" = one corrector dispatch in node order.
+  examples::cpu_solver*            solver         = nullptr;                                        // CPU solver.
+  std::vector<nu_float4_structure> gpu_position;                                                    // GPU position (validation).
+  float                            error          = 0.0f;                                           // CPU/GPU maximum distance [m].
+  std::vector<nu_float4_structure> state_position[2];                                               // Position (precision comparison: float, half) [m].
+  double                           state_time[2];                                                   // Step time (precision comparison: float, half) [us].
+  float                            state_error    = 0.0f;                                           // Half/float maximum distance [m].
+  size_t                           state;                                                           // State precision (0 = float, 1 = half).
+
+  // WATCHDOG:
+  bool                             halt           = false;                                          // "true" = halt the run on divergence.
+  bool                             rollback       = false;                                          // "true" = roll back to the last checkpoint on divergence.
+  bool                             halted         = false;                                          // "true" = run halted.
+  bool                             rolled         = false;                                          // "true" = rolled back since the last checkpoint.
+  bool                             diverged;                                                        // "true" = divergence detected.
+  size_t                           watch_chunks;                                                    // Watchdog chunks (work-items) [#].
+  std::string                      watch_action;                                                    // Watchdog action.
+  std::ofstream                    watch_log;                                                       // Watchdog time series.
+
+  // PATCHES:
+  examples::patches*               edits          = new examples::patches (PATCH_TARGETS);          // Sparse parameter patches.
+  std::vector<int>                 region_node;                                                     // Patch region nodes.
+  std::vector<int>                 region_link;                                                     // Patch region links.
+  bool                             pinned         = false;                                          // "true" = patch region pinned.
+  bool                             stiffened      = false;                                          // "true" = patch region stiffened.
+  bool                             circle         = false;                                          // "CIRCLE" button (previous frame).
+  bool                             square         = false;                                          // "SQUARE" button (previous frame).
+  size_t                           patched;                                                         // Patches taken [#].
+
   // BACKUP:
   std::vector<nu_float4_structure> initial_position;                                                // Backing up initial data...
   std::vector<nu_float4_structure> initial_position_int;                                            // Backing up initial data...
   std::vector<nu_float4_structure> initial_velocity;                                                // Backing up initial data...
   std::vector<nu_float4_structure> initial_velocity_int;                                            // Backing up initial data...
   std::vector<nu_float4_structure> initial_acceleration;                                            // Backing up initial data...
+  std::vector<float>               initial_stiffness;                                               // Backing up initial data...
+  std::vector<int>                 initial_freedom;                                                 // Backing up initial data...
+
+  // THREADS:
+  std::thread                      simulation;                                                      // Simulation thread.
+  examples::triple_buffer<snapshot> frames;                                                         // Simulation snapshots.
+  std::atomic<bool>                running (true);                                                  // Simulation running flag.
+  std::atomic<bool>                reset (false);                                                   // Simulation reset request.
+  bool                             publishing;                                                      // "true" = snapshot to be published.
+  std::atomic<size_t>              granted (0);                                                     // Simulation steps granted by the frames (lockstep).
+  std::mutex                       grant_lock;                                                      // Step grant lock (lockstep).
+  std::condition_variable          grant_signal;                                                    // Step grant signal (lockstep).
+  double                           build_time = 0.0;                                                // Grid build time [us].
+  double                           query_time = 0.0;                                                // Grid query time [us].
+  double                           corr_time  = 0.0;                                                // Corrector time [us].
+  std::vector<double>              bucket_time;                                                     // Corrector time (per bucket dispatch) [us].
+  size_t                           step  = 0;                                                       // Simulation step [#].
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////// COMMAND LINE //////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  // --cpu:      the simulation runs on the CPU solver (no OpenCL device needed).
+  // --validate: the CPU solver is checked against the OpenCL kernels at start-up.
+  // --precision-report: the half and float intermediate state are compared at start-up.
+  // --halt:     the run is halted when the watchdog detects a divergence.
+  // --rollback: the run is rolled back to the last checkpoint when the watchdog detects a divergence.
+  // --unsorted: the corrector runs as one dispatch over all nodes instead of one per degree bucket.
+  // --record:   every RECORD_STEPS steps a frame is rendered offscreen and written to disk.
+  // --capture:  the input of every frame is logged, FRAME_STEPS simulation steps per frame.
+  // --replay:   the frames are driven by the input log, FRAME_STEPS simulation steps per frame.
+  // --config <file>:          the parameters are read from a "key = value" file.
+  // --set <key>=<value>:      a parameter is overridden (after all the files, in command line order).
+  // --sweep <key>=<v1,v2...>: a parameter is swept; the grid of all the swept parameters is run
+  //                           SWEEP_STEPS steps per point on the OpenCL backend, then the run ends.
+  for(i = 1; i < (size_t)argc; i++)
+  {
+    if(strcmp (argv[i], "--cpu") == 0)
+    {
+      cpu = true;                                                                                   // Selecting CPU backend...
+    }
+    else if(strcmp (argv[i], "--validate") == 0)
+    {
+      validate = true;                                                                              // Requesting validation...
+    }
+    else if(strcmp (argv[i], "--precision-report") == 0)
+    {
+      report = true;                                                                                // Requesting precision report...
+    }
+    else if(strcmp (argv[i], "--halt") == 0)
+    {
+      halt = true;                                                                                  // Requesting halt on divergence...
+    }
+    else if(strcmp (argv[i], "--rollback") == 0)
+    {
+      rollback = true;                                                                              // Requesting rollback on divergence...
+    }
+    else if(strcmp (argv[i], "--unsorted") == 0)
+    {
+      unsorted = true;                                                                              // Selecting node order...
+    }
+    else if(strcmp (argv[i], "--record") == 0)
+    {
+      record = true;                                                                                // Requesting recording...
+    }
+    else if(strcmp (argv[i], "--capture") == 0)
+    {
+      capture = true;                                                                               // Requesting input capture...
+    }
+    else if(strcmp (argv[i], "--replay") == 0)
+    {
+      replay = true;                                                                                // Requesting input replay...
+    }
+    else if((strcmp (argv[i], "--config") == 0) || (strcmp (argv[i], "--set") == 0) ||
+            (strcmp (argv[i], "--sweep") == 0))
+    {
+      if((i + 1) == (size_t)argc)
+      {
+        std::cout << "Error: missing argument for " << argv[i] << std::endl;                        // Printing message...
+        exit (EXIT_FAILURE);                                                                        // Exiting...
+      }
+
+      if(strcmp (argv[i], "--config") == 0)
+      {
+        settings->load (argv[i + 1]);                                                               // Loading configuration...
+      }
+      else if(strcmp (argv[i], "--set") == 0)
+      {
+        overrides.push_back (argv[i + 1]);                                                          // Deferring override...
+      }
+      else
+      {
+        sweeps.push_back (argv[i + 1]);                                                             // Deferring sweep axis...
+      }
+
+      i++;                                                                                          // Skipping argument...
+    }
+    else
+    {
+      std::cout << "Error: unknown option " << argv[i] << std::endl;                                // Printing message...
+      exit (EXIT_FAILURE);                                                                          // Exiting...
+    }
+  }
+
+  // APPLYING OVERRIDES (after all the configuration files, whatever the command line order):
+  for(auto& o : overrides)
+  {
+    settings->set (o);                                                                              // Overriding parameter...
+  }
+
+  for(auto& w : sweeps)
+  {
+    settings->sweep (w);                                                                            // Adding sweep axis...
+  }
+
+  // SETTING CONFIGURATION (the defaults being the compile-time ones; only the physical parameters,
+  // derived again at each point, can be swept):
+  settings->check (
+                   {"mesh", "surface_tag", "ds", "epsilon", "sweep_steps", "h", "rho", "E", "mu", "g"},
+                   {"h", "rho", "E", "mu", "g"}
+                  );                                                                                // Checking keys...
+  mesh_file   = settings->get ("mesh", MESH);                                                       // Getting GMSH mesh...
+  surface_tag = settings->get ("surface_tag", SURFACE_TAG);                                         // Getting surface tag...
+  ds          = settings->get ("ds", (float)DS);                                                    // Getting cell side...
+  epsilon     = settings->get ("epsilon", (float)EPSILON);                                          // Getting cell detection tolerance...
+  sweep_steps = settings->get ("sweep_steps", (size_t)SWEEP_STEPS);                                 // Getting sweep point length...
+  points      = settings->points ();                                                                // Getting sweep points...
+  cloth       = new nu::mesh (std::string (GMSH_HOME) + mesh_file);                                 // Loading mesh...
+
+  if((points > 0) && cpu)
+  {
+    std::cout << "Error: parameter sweeps run on the OpenCL backend" << std::endl;                  // Printing message...
+    exit (EXIT_FAILURE);                                                                            // Exiting...
+  }
+
+  // SETTING LOCKSTEP (input capture and replay):
+  lockstep = capture || replay;                                                                     // Setting lockstep...
+
+  if(lockstep)
+  {
+    inputs   = new examples::input_log (INPUT_LOG, replay);                                         // Opening input log...
+    granted  = FRAME_STEPS;                                                                         // Granting first frame steps...
+    halt     = false;                                                                               // Disabling halt (the frames must go on)...
+    rollback = false;                                                                               // Disabling rollback (the frames must go on)...
+    timing_log.open (TIMING_LOG);                                                                   // Opening timing log...
+    timing_log << "frame,step,compute_us,render_us,frame_us" << std::endl;                          // Writing header...
+  }
+
+  if(!cpu || validate)
+  {
+    cl = new nu::opencl (NU_GPU);                                                                   // Creating OpenCL context...
+  }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   ///////////////////////////////////////// DATA INITIALIZATION ///////////////////////////////////////
@@ -155,20 +487,31 @@ int main ()
   cloth->process (SIDE_Y_TAG, SIDE_Y_DIM, NU_MSH_PNT);                                              // Processing mesh...
   side_y_nodes    = cloth->node.size ();                                                            // Getting number of nodes along "y" side...
 
-  // COMPUTING PHYSICAL PARAMETERS:
+  // COMPUTING PHYSICAL PARAMETERS (configured, or set by the current sweep point):
   dx              = (x_max - x_min)/(side_x_nodes - 1);                                             // x-axis mesh spatial size [m].
   dy              = (y_max - y_min)/(side_y_nodes - 1);                                             // y-axis mesh spatial size [m].
-  m               = rho*h*dx*dy;                                                                    // Node mass [kg].
-  K               = E*h*dy/dx;                                                                      // Elastic constant [kg/s^2].
-  B               = mu*h*dx*dy;                                                                     // Damping [kg*s*m].
-  dt_critical     = sqrt (m/K);                                                                     // Critical time step [s].
-  dt_simulation   = 0.5f*dt_critical;                                                               // Simulation time step [s].
+
+  auto physics = [&]()
+                 {
+                   h             = settings->get ("h", h);                                          // Getting cloth's thickness [m]...
+                   rho           = settings->get ("rho", rho);                                      // Getting cloth's mass density [kg/m^3]...
+                   E             = settings->get ("E", E);                                          // Getting cloth's Young modulus [kg/(m*s^2)]...
+                   mu            = settings->get ("mu", mu);                                        // Getting cloth's viscosity [Pa*s]...
+                   g             = settings->get ("g", g);                                          // Getting external gravity field [m/s^2]...
+                   m             = rho*h*dx*dy;                                                     // Node mass [kg].
+                   K             = E*h*dy/dx;                                                       // Elastic constant [kg/s^2].
+                   B             = mu*h*dx*dy;                                                      // Damping [kg*s*m].
+                   dt_critical   = sqrt (m/K);                                                      // Critical time step [s].
+                   dt_simulation = 0.5f*dt_critical;                                                // Simulation time step [s].
+                 };
+
+  physics ();                                                                                       // Computing physical parameters...
   dt->data.push_back (dt_simulation);                                                               // Setting simulation time step...
   friction->data.push_back (B);                                                                     // Setting friction...
   gravity->data.push_back ({0.0f, 0.0f, -g, 1.0f});                                                 // Setting gravity...
 
   // MESH SURFACE:
-  cloth->process (SURFACE_TAG, SURFACE_DIM, NU_MSH_QUA_4);                                          // Processing mesh...
+  cloth->process (surface_tag, SURFACE_DIM, NU_MSH_QUA_4);                                          // Processing mesh...
   position->data  = cloth->node_coordinates;                                                        // Setting all node coordinates...
   neighbour->data = cloth->neighbour;                                                               // Setting neighbour indices...
   offset->data    = cloth->neighbour_offset;                                                        // Setting neighbour offsets...
@@ -182,6 +525,35 @@ int main ()
   std::cout << "groups = " << groups/CELL_VERTICES << std::endl;                                    // Printing message...
   std::cout << "neighbours = " << neighbours << std::endl;                                          // Printing message...
 
+  // SETTING DEGREE BUCKETS:
+  node_buckets      = new examples::buckets (offset->data);                                         // Bucketing nodes by degree...
+  bucket_node->data = node_buckets->node;                                                           // Setting nodes (sorted by degree)...
+  bucket->data      = node_buckets->table (unsorted);                                               // Setting bucket table (written once)...
+
+  for(i = 0; i < node_buckets->start.size (); i++)
+  {
+    std::cout << "bucket " << i << ": degree = " << node_buckets->degree[i] << ", nodes = "
+              << node_buckets->size[i] << std::endl;                                                // Printing message...
+  }
+
+  std::cout << "SIMD efficiency model (width = " << SIMD_WIDTH << ", not measured): node order = "
+            << node_buckets->unsorted (SIMD_WIDTH) << ", degree buckets = "
+            << node_buckets->sorted (SIMD_WIDTH) << std::endl;                                      // Printing message...
+
+  // SETTING TRIANGLES (2 per quadrangle):
+  for(i = 0; i < elements/CELL_VERTICES; i++)
+  {
+    for(j = 0; j < 2; j++)
+    {
+      triangle->data.push_back (cloth->element[CELL_VERTICES*i + 0]);                               // Setting vertex "a"...
+      triangle->data.push_back (cloth->element[CELL_VERTICES*i + j + 1]);                           // Setting vertex "b"...
+      triangle->data.push_back (cloth->element[CELL_VERTICES*i + j + 2]);                           // Setting vertex "c"...
+    }
+  }
+
+  triangles = triangle->data.size ()/3;                                                             // Getting the number of triangles...
+  std::cout << "triangles = " << triangles << std::endl;                                            // Printing message...
+
   // SETTING NEUTRINO ARRAYS ("surface" depending):
   for(i = 0; i < nodes; i++)
   {
@@ -190,6 +562,7 @@ int main ()
     velocity->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                            // Setting initial velocity...
     velocity_int->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                        // Setting initial intermediate velocity...
     acceleration->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                        // Setting initial acceleration...
+    contact_force->data.push_back ({0.0f, 0.0f, 0.0f, 1.0f});                                       // Setting initial contact force...
     mass->data.push_back (m);                                                                       // Setting mass...
     freedom->data.push_back (1);                                                                    // Setting freedom flag...
 
@@ -207,18 +580,17 @@ int main ()
 
     for(j = j_min; j < j_max; j++)
     {
-      central->data.push_back (cloth->node[i]);                                                     // Building central node tuple...
       stiffness->data.push_back (K);                                                                // Setting link stiffness...
 
       std::cout << " " << neighbour->data[j];                                                       // Printing message...
 
-      if(resting->data[j] > (DS + EPSILON))
+      if(resting->data[j] > (ds + epsilon))
       {
-        color->data.push_back ({1.0f, 0.0f, 0.0f, 0.1f});                                           // Setting link color...
+        color->data.push_back (0x1A0000FF);                                                         // Setting link color (red, alpha 0.1)...
       }
       else
       {
-        color->data.push_back ({0.0f, 1.0f, 0.0f, 1.0f});                                           // Setting link color...
+        color->data.push_back ((int)0xFF00FF00);                                                    // Setting link color (green, opaque)...
       }
     }
 
@@ -236,22 +608,159 @@ int main ()
     freedom->data[border[i]] = 0;                                                                   // Resetting freedom flag...
   }
 
+  // SETTING PATCH REGION (nodes above the obstacle and their links, both ways):
+  for(i = 0; i < nodes; i++)
+  {
+    if(
+       pow (position->data[i].x - OBSTACLE_X, 2) + pow (position->data[i].y - OBSTACLE_Y, 2) <
+       PATCH_RADIUS*PATCH_RADIUS
+      )
+    {
+      region_node.push_back ((int)i);                                                               // Adding region node...
+    }
+  }
+
+  for(i = 0; i < nodes; i++)
+  {
+    j_min = (i == 0) ? 0 : offset->data[i - 1];                                                     // Setting minimum element offset index...
+    j_max = offset->data[i];                                                                        // Setting maximum element offset index...
+
+    for(j = j_min; j < j_max; j++)
+    {
+      if(
+         std::binary_search (region_node.begin (), region_node.end (), (int)i) ||
+         std::binary_search (region_node.begin (), region_node.end (), neighbour->data[j])
+        )
+      {
+        region_link.push_back ((int)j);                                                             // Adding region link...
+      }
+    }
+  }
+
+  std::cout << "patch region: nodes = " << region_node.size () << ", links = "
+            << region_link.size () << std::endl;                                                    // Printing message...
+
+  // SETTING SPATIAL HASH (the triangles are binned by bounding box, so that the cell size needs only
+  // to cover the contact radius, however much the cloth stretches):
+  radius    = 0.5f*std::min (dx, dy);                                                               // Setting contact radius...
+  cell_size = 2.0f*radius;                                                                          // Setting grid cell size...
+  cells     = 1;                                                                                    // Initializing number of cells...
+
+  while(cells < 2*std::max (nodes, triangles))
+  {
+    cells *= 2;                                                                                     // Doubling cells (power of 2)...
+  }
+
+  cell_count->data.assign (cells, 0);                                                               // Setting cell node counters...
+  cell_node->data.assign (cells*NODE_CAP, 0);                                                       // Setting cell nodes...
+  cell_tri_count->data.assign (cells, 0);                                                           // Setting cell triangle counters...
+  cell_triangle->data.assign (cells*TRIANGLE_CAP, 0);                                               // Setting cell triangles...
+  contact->data = {cell_size, radius, K, OBSTACLE_X, OBSTACLE_Y, OBSTACLE_Z, OBSTACLE_R};           // Setting contact parameters...
+  grid->data    = {(int)cells, NODE_CAP, TRIANGLE_CAP, (int)triangles, TRIANGLE_SPAN, 0, 0};        // Setting grid parameters (+ overflow counters)...
+  std::cout << "cells = " << cells << ", cell size = " << cell_size << std::endl;                   // Printing message...
+
+  // SETTING WATCHDOG:
+  watch_chunks = (nodes + WATCH_CHUNK - 1)/WATCH_CHUNK;                                             // Setting watchdog chunks...
+  watch_partial->data.assign (watch_chunks*WATCH_SIZE, 0.0f);                                       // Setting watchdog partial reductions...
+  watch->data.assign (WATCH_SIZE, 0.0f);                                                            // Setting watchdog reductions...
+  watchdog->data = {(int)nodes, (int)watch_chunks};                                                 // Setting watchdog parameters...
+
+  // SETTING PATCHES:
+  patch_index->data.assign (PATCH_MAX, 0);                                                          // Setting patch indices...
+  patch_value->data.assign (PATCH_MAX, 0.0f);                                                       // Setting patch values...
+  patch->data = {0, 0};                                                                             // Setting patch parameters...
+
   // SETTING INITIAL DATA BACKUP:
   initial_position     = position->data;                                                            // Setting backup data...
   initial_position_int = position_int->data;                                                        // Setting backup data...
   initial_velocity     = velocity->data;                                                            // Setting backup data...
   initial_velocity_int = velocity_int->data;                                                        // Setting backup data...
   initial_acceleration = acceleration->data;                                                        // Setting backup data...
+  initial_stiffness    = stiffness->data;                                                           // Setting backup data...
+  initial_freedom      = freedom->data;                                                             // Setting backup data...
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENCL KERNELS INITIALIZATION //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  K1->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                              // Setting kernel source file...
-  K1->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_1));                               // Setting kernel source file...
-  K1->build (nodes, 0, 0);                                                                          // Building kernel program...
-  K2->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                              // Setting kernel source file...
-  K2->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                               // Setting kernel source file...
-  K2->build (nodes, 0, 0);                                                                          // Building kernel program...
+  if(cl != nullptr)
+  {
+    K1->addsource (std::string (KERNEL_HOME) + std::string (PRECISION));                            // Setting kernel source file...
+    K1->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                            // Setting kernel source file...
+    K1->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_1));                             // Setting kernel source file...
+    K1->build (nodes, 0, 0);                                                                        // Building kernel program...
+    K2->addsource (std::string (KERNEL_HOME) + std::string (PRECISION));                            // Setting kernel source file...
+    K2->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                            // Setting kernel source file...
+    K2->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                             // Setting kernel source file...
+    K2->build (nodes, 0, 0);                                                                        // Building kernel program...
+
+    for(i = 0; i < node_buckets->start.size (); i++)
+    {
+      K2_bucket.push_back (new nu::kernel ());                                                      // Adding bucket kernel...
+      K2_bucket[i]->addsource (std::string (KERNEL_HOME) + std::string (PRECISION));                // Setting kernel source file...
+      K2_bucket[i]->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                // Setting kernel source file...
+      K2_bucket[i]->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                 // Setting kernel source file...
+      K2_bucket[i]->build (node_buckets->size[i], 0, 0);                                            // Building kernel program...
+    }
+
+    if(!unsorted)
+    {
+      bucket_time.assign (K2_bucket.size (), 0.0);                                                  // Setting dispatch times (profiler)...
+    }
+
+    K3->addsource (std::string (KERNEL_HOME) + std::string (GRID));                                 // Setting kernel source file...
+    K3->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_3));                             // Setting kernel source file...
+    K3->build (cells, 0, 0);                                                                        // Building kernel program...
+    K4->addsource (std::string (KERNEL_HOME) + std::string (PRECISION));                            // Setting kernel source file...
+    K4->addsource (std::string (KERNEL_HOME) + std::string (GRID));                                 // Setting kernel source file...
+    K4->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_4));                             // Setting kernel source file...
+    K4->build (nodes, 0, 0);                                                                        // Building kernel program...
+    K5->addsource (std::string (KERNEL_HOME) + std::string (PRECISION));                            // Setting kernel source file...
+    K5->addsource (std::string (KERNEL_HOME) + std::string (GRID));                                 // Setting kernel source file...
+    K5->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_5));                             // Setting kernel source file...
+    K5->build (triangles, 0, 0);                                                                    // Building kernel program...
+    K6->addsource (std::string (KERNEL_HOME) + std::string (PRECISION));                            // Setting kernel source file...
+    K6->addsource (std::string (KERNEL_HOME) + std::string (GRID));                                 // Setting kernel source file...
+    K6->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_6));                             // Setting kernel source file...
+    K6->build (nodes, 0, 0);                                                                        // Building kernel program...
+    K7->addsource (std::string (KERNEL_HOME) + std::string (WATCH));                                // Setting kernel source file...
+    K7->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_7));                             // Setting kernel source file...
+    K7->build (watch_chunks, 0, 0);                                                                 // Building kernel program (one work-item per chunk)...
+    K8->addsource (std::string (KERNEL_HOME) + std::string (WATCH));                                // Setting kernel source file...
+    K8->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_8));                             // Setting kernel source file...
+    K8->build (1, 0, 0);                                                                            // Building kernel program (a single work-item)...
+    K9->addsource (std::string (KERNEL_HOME) + std::string (PRECISION));                            // Setting kernel source file...
+    K9->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_9));                             // Setting kernel source file...
+    K9->build (nodes, 0, 0);                                                                        // Building kernel program...
+    K10->addsource (std::string (KERNEL_HOME) + std::string (PRECISION));                           // Setting kernel source file...
+    K10->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_10));                           // Setting kernel source file...
+    K10->build (nodes, 0, 0);                                                                       // Building kernel program...
+    K11->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_11));                           // Setting kernel source file...
+    K11->build (PATCH_MAX, 0, 0);                                                                   // Building kernel program...
+  }
+
+  if((cl != nullptr) && report)
+  {
+    K1_alt->addsource (std::string (KERNEL_HOME) + std::string (PRECISION_ALT));                    // Setting kernel source file...
+    K1_alt->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                        // Setting kernel source file...
+    K1_alt->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_1));                         // Setting kernel source file...
+    K1_alt->build (nodes, 0, 0);                                                                    // Building kernel program (compared precision)...
+    K2_alt->addsource (std::string (KERNEL_HOME) + std::string (PRECISION_ALT));                    // Setting kernel source file...
+    K2_alt->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                        // Setting kernel source file...
+    K2_alt->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                         // Setting kernel source file...
+    K2_alt->build (nodes, 0, 0);                                                                    // Building kernel program (compared precision)...
+    K4_alt->addsource (std::string (KERNEL_HOME) + std::string (PRECISION_ALT));                    // Setting kernel source file...
+    K4_alt->addsource (std::string (KERNEL_HOME) + std::string (GRID));                             // Setting kernel source file...
+    K4_alt->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_4));                         // Setting kernel source file...
+    K4_alt->build (nodes, 0, 0);                                                                    // Building kernel program (compared precision)...
+    K5_alt->addsource (std::string (KERNEL_HOME) + std::string (PRECISION_ALT));                    // Setting kernel source file...
+    K5_alt->addsource (std::string (KERNEL_HOME) + std::string (GRID));                             // Setting kernel source file...
+    K5_alt->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_5));                         // Setting kernel source file...
+    K5_alt->build (triangles, 0, 0);                                                                // Building kernel program (compared precision)...
+    K6_alt->addsource (std::string (KERNEL_HOME) + std::string (PRECISION_ALT));                    // Setting kernel source file...
+    K6_alt->addsource (std::string (KERNEL_HOME) + std::string (GRID));                             // Setting kernel source file...
+    K6_alt->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_6));                         // Setting kernel source file...
+    K6_alt->build (nodes, 0, 0);                                                                    // Building kernel program (compared precision)...
+  }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENGL SHADERS INITIALIZATION //////////////////////////////////
@@ -259,59 +768,757 @@ int main ()
   S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), NU_VERTEX);                  // Setting shader source file...
   S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), NU_GEOMETRY);                // Setting shader source file...
   S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), NU_FRAGMENT);                // Setting shader source file...
-  S->build (neighbours);                                                                            // Building shader program...
+  S->build (0);                                                                                     // Building shader program (no points: it only holds the camera)...
+  links = new examples::link_renderer (std::string (LINK_HOME) + std::string (SHADER_COMP),         // Building link renderer...
+                                        std::string (LINK_HOME) + std::string (SHADER_CULL),
+                                        std::string (LINK_HOME) + std::string (SHADER_LINK),
+                                        std::string (SHADER_HOME) + std::string (SHADER_FRAG),
+                                        examples::link_renderer::define ("COLOR_RGBA8", 1) +
+                                        examples::link_renderer::define ("COLOR_BINDING", DRAW_COLOR) +
+                                        examples::link_renderer::define ("POSITION_BINDING", DRAW_POSITION) +
+                                        examples::link_renderer::define ("OFFSET_BINDING", DRAW_OFFSET) +
+                                        examples::link_renderer::define ("NEAREST_BINDING", DRAW_NEAREST),
+                                        DRAW_CLIP, LINK_PIXELS);
+
+  if(record)
+  {
+    video = new examples::recorder (SX, SY, RECORD_SLOTS, RECORD_QUEUE, RECORD_PREFIX);             // Building frame recorder...
+    glfwSwapInterval (0);                                                                           // Unlocking frame rate from display refresh...
+  }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// SETTING OPENCL KERNEL ARGUMENTS //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  cl->write ();                                                                                     // Writing OpenCL data...
+  // The intermediate state is set (and restored) in single precision: when the kernels store it in
+  // half precision it is packed right before being written, the buffers taking half the size. Only
+  // the precision report, running the kernels of both precisions on the same buffers, keeps the
+  // single precision size.
+  auto pack_state = [&](bool loc_half = HALF_STATE)
+                    {
+                      if(loc_half)
+                      {
+                        position_int->data = examples::half::pack (position_int->data);             // Packing intermediate position...
+                        velocity_int->data = examples::half::pack (velocity_int->data);             // Packing intermediate velocity...
+                        acceleration->data = examples::half::pack (acceleration->data);             // Packing acceleration...
+
+                        if(report)
+                        {
+                          position_int->data.resize (nodes, {0.0f, 0.0f, 0.0f, 0.0f});              // Keeping buffer size...
+                          velocity_int->data.resize (nodes, {0.0f, 0.0f, 0.0f, 0.0f});              // Keeping buffer size...
+                          acceleration->data.resize (nodes, {0.0f, 0.0f, 0.0f, 0.0f});              // Keeping buffer size...
+                        }
+                      }
+                    };
+
+  if(cl != nullptr)
+  {
+    pack_state ();                                                                                  // Packing state...
+    ckpt_position->data = position->data;                                                           // Setting initial checkpoint...
+    ckpt_velocity->data = velocity->data;                                                           // Setting initial checkpoint...
+    ckpt_accel->data    = acceleration->data;                                                       // Setting initial checkpoint (packed as the state)...
+    cl->write ();                                                                                   // Writing OpenCL data...
+  }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  ////////////////////////////////////////// APPLICATION LOOP /////////////////////////////////////////
+  ///////////////////////////////////////////// CPU SOLVER ////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  while(!gl->closed ())                                                                             // Opening window...
+  if(cpu || validate)
   {
-    cl->get_tic ();                                                                                 // Getting "tic" [us]...
-    cl->acquire ();                                                                                 // Acquiring OpenCL kernel...
-    cl->execute (K1, NU_WAIT);                                                                      // Executing OpenCL kernel...
-    cl->execute (K2, NU_WAIT);                                                                      // Executing OpenCL kernel...
-    cl->release ();                                                                                 // Releasing OpenCL kernel...
+    solver = new examples::cpu_solver (
+                                       std::thread::hardware_concurrency (),
+                                       CPU_BLOCK,
+                                       color->data,
+                                       position->data,
+                                       velocity->data,
+                                       acceleration->data,
+                                       position_int->data,
+                                       velocity_int->data,
+                                       gravity->data,
+                                       stiffness->data,
+                                       resting->data,
+                                       friction->data,
+                                       mass->data,
+                                       neighbour->data,
+                                       offset->data,
+                                       freedom->data,
+                                       dt->data,
+                                       contact->data
+                                      );                                                            // Creating CPU solver...
+    std::cout << "CPU solver: threads = " << solver->threads () << ", nodes per SIMD pack = "
+              << examples::simd_wide::nodes << std::endl;                                           // Printing message...
+  }
 
-    gl->clear ();                                                                                   // Clearing gl...
-    gl->poll_events ();                                                                             // Polling gl events...
-    gl->mouse_navigation (ms_orbit_rate, ms_pan_rate, ms_decaytime);                                // Polling mouse...
-    gl->gamepad_navigation (gmp_orbit_rate, gmp_pan_rate, gmp_decaytime, gmp_deadzone);             // Polling gamepad...
-    gl->plot (S);                                                                                   // Plotting shared arguments...
-    gl->refresh ();                                                                                 // Refreshing gl...
+  // CORRECTOR (one dispatch per degree bucket, or one over all nodes in their own order): the
+  // kernels move along the bucket table themselves, nothing is written between the dispatches.
+  auto corrector = [&](std::vector<double>* loc_time = nullptr)
+                   {
+                     if(unsorted)
+                     {
+                       cl->execute (K2, NU_WAIT);                                                   // Executing OpenCL kernel (corrector)...
+                     }
+                     else
+                     {
+                       for(size_t b = 0; b < K2_bucket.size (); b++)
+                       {
+                         auto d0 = std::chrono::steady_clock::now ();                               // Dispatch start.
+                         cl->execute (K2_bucket[b], NU_WAIT);                                       // Executing OpenCL kernel (corrector)...
+
+                         if(loc_time != nullptr)
+                         {
+                           (*loc_time)[b] += std::chrono::duration<double, std::micro>(
+                                               std::chrono::steady_clock::now () - d0).count ();    // Accumulating dispatch time...
+                         }
+                       }
+                     }
+                   };
 
-    if(gl->button_CROSS)
+  // COMPARING HALF WITH SINGLE PRECISION INTERMEDIATE STATE (same initial state, same number of
+  // steps, one corrector dispatch over all nodes):
+  if((cl != nullptr) && report)
+  {
+    bucket->data = node_buckets->table (true);                                                      // Setting bucket table (node order)...
+    cl->write (30);                                                                                 // Writing bucket table...
+
+    for(state = 0; state < 2; state++)
     {
-      gl->close ();                                                                                 // Closing gl...
+      bool alt = ((state == 1) != HALF_STATE);                                                      // "true" = compared precision kernels.
+
+      for(j = 0; j < 2; j++)
+      {
+        position->data     = initial_position;                                                      // Restoring backup...
+        position_int->data = initial_position_int;                                                  // Restoring backup...
+        velocity->data     = initial_velocity;                                                      // Restoring backup...
+        velocity_int->data = initial_velocity_int;                                                  // Restoring backup...
+        acceleration->data = initial_acceleration;                                                  // Restoring backup...
+        pack_state (state == 1);                                                                    // Packing state (half precision)...
+        cl->write (1);                                                                              // Writing data...
+        cl->write (2);                                                                              // Writing data...
+        cl->write (3);                                                                              // Writing data...
+        cl->write (4);                                                                              // Writing data...
+        cl->write (5);                                                                              // Writing data...
+
+        auto t0 = std::chrono::steady_clock::now ();                                                // Run start.
+
+        for(i = 0; i < ((j == 0) ? 1 : CHECK_STEPS); i++)
+        {
+          cl->execute (alt ? K1_alt : K1, NU_WAIT);                                                 // Executing OpenCL kernel (predictor)...
+          cl->execute (K3, NU_WAIT);                                                                // Executing OpenCL kernel (grid clear)...
+          cl->execute (alt ? K4_alt : K4, NU_WAIT);                                                 // Executing OpenCL kernel (grid nodes)...
+          cl->execute (alt ? K5_alt : K5, NU_WAIT);                                                 // Executing OpenCL kernel (grid triangles)...
+          cl->execute (alt ? K6_alt : K6, NU_WAIT);                                                 // Executing OpenCL kernel (contact)...
+          cl->execute (alt ? K2_alt : K2, NU_WAIT);                                                 // Executing OpenCL kernel (corrector)...
+        }
+
+        auto t1 = std::chrono::steady_clock::now ();                                                // Run end.
+        state_time[state] = std::chrono::duration<double, std::micro>(t1 - t0).count ();            // Getting run time (after a warm-up step)...
+      }
+
+      state_time[state] /= CHECK_STEPS;                                                             // Computing step time...
+
+      cl->read (1);                                                                                 // Reading position...
+      state_position[state] = position->data;                                                       // Storing position...
     }
 
-    if(gl->button_TRIANGLE)
+    for(i = 0; i < nodes; i++)
     {
+      state_error = std::max (
+                              state_error,
+                              sqrtf (
+                                     powf (state_position[1][i].x - state_position[0][i].x, 2) +
+                                     powf (state_position[1][i].y - state_position[0][i].y, 2) +
+                                     powf (state_position[1][i].z - state_position[0][i].z, 2)
+                                    )
+                             );                                                                     // Computing half/float distance...
+    }
+
+    std::cout << "precision: intermediate state = " << (HALF_STATE ? "half" : "float")
+              << ", half (24 bytes/node): " << state_time[1] << " us/step, float (48 bytes/node): "
+              << state_time[0] << " us/step, max |x_half - x_float| = " << state_error << " m after "
+              << CHECK_STEPS << " steps" << std::endl;                                              // Printing precision report...
+
+    position->data     = initial_position;                                                          // Restoring backup...
+    position_int->data = initial_position_int;                                                      // Restoring backup...
+    velocity->data     = initial_velocity;                                                          // Restoring backup...
+    velocity_int->data = initial_velocity_int;                                                      // Restoring backup...
+    acceleration->data = initial_acceleration;                                                      // Restoring backup...
+    pack_state ();                                                                                  // Packing state...
+    cl->write (1);                                                                                  // Writing data...
+    cl->write (2);                                                                                  // Writing data...
+    cl->write (3);                                                                                  // Writing data...
+    cl->write (4);                                                                                  // Writing data...
+    cl->write (5);                                                                                  // Writing data...
+    bucket->data = node_buckets->table (unsorted);                                                  // Restoring bucket table...
+    cl->write (30);                                                                                 // Writing bucket table...
+  }
+
+  // VALIDATING CPU SOLVER AGAINST OPENCL KERNELS (same initial state, same number of steps):
+  if(validate)
+  {
+    for(i = 0; i < CHECK_STEPS; i++)
+    {
+      cl->execute (K1, NU_WAIT);                                                                    // Executing OpenCL kernel (predictor)...
+      cl->execute (K3, NU_WAIT);                                                                    // Executing OpenCL kernel (grid clear)...
+      cl->execute (K4, NU_WAIT);                                                                    // Executing OpenCL kernel (grid nodes)...
+      cl->execute (K5, NU_WAIT);                                                                    // Executing OpenCL kernel (grid triangles)...
+      cl->execute (K6, NU_WAIT);                                                                    // Executing OpenCL kernel (contact)...
+      corrector ();                                                                                 // Executing OpenCL kernels (corrector)...
+    }
+
+    cl->read (1);                                                                                   // Reading position...
+    gpu_position       = position->data;                                                            // Storing GPU position...
+    position->data     = initial_position;                                                          // Restoring backup...
+    position_int->data = initial_position_int;                                                      // Restoring backup...
+    velocity->data     = initial_velocity;                                                          // Restoring backup...
+    velocity_int->data = initial_velocity_int;                                                      // Restoring backup...
+    acceleration->data = initial_acceleration;                                                      // Restoring backup...
+
+    for(i = 0; i < CHECK_STEPS; i++)
+    {
+      solver->step ();                                                                              // Advancing CPU solver...
+    }
+
+    for(i = 0; i < nodes; i++)
+    {
+      error = std::max (
+                        error,
+                        sqrtf (
+                               powf (position->data[i].x - gpu_position[i].x, 2) +
+                               powf (position->data[i].y - gpu_position[i].y, 2) +
+                               powf (position->data[i].z - gpu_position[i].z, 2)
+                              )
+                       );                                                                           // Computing CPU/GPU distance...
+    }
+
+    std::cout << "validation: max |x_cpu - x_gpu| = " << error << " m after " << CHECK_STEPS
+              << " steps (tolerance = " << TOLERANCE << " m): "
+              << ((error <= TOLERANCE) ? "PASSED" : "FAILED") << std::endl;                         // Printing validation report...
+
+    position->data     = initial_position;                                                          // Restoring backup...
+    position_int->data = initial_position_int;                                                      // Restoring backup...
+    velocity->data     = initial_velocity;                                                          // Restoring backup...
+    velocity_int->data = initial_velocity_int;                                                      // Restoring backup...
+    acceleration->data = initial_acceleration;                                                      // Restoring backup...
+
+    if(!cpu)
+    {
+      pack_state ();                                                                                // Packing state (the CPU solver keeps it unpacked)...
+    }
+
+    cl->write (1);                                                                                  // Writing data...
+    cl->write (2);                                                                                  // Writing data...
+    cl->write (3);                                                                                  // Writing data...
+    cl->write (4);                                                                                  // Writing data...
+    cl->write (5);                                                                                  // Writing data...
+  }
+
+  // APPLYING PATCHES (scattered on the device in chunks of PATCH_MAX, or set on the host vectors
+  // shared with the CPU solver). Neutrino writes whole buffers: each chunk uploads the full PATCH_MAX
+  // index and value buffers, whatever the number of patches it holds.
+  auto apply_patches = [&]()
+                       {
+                         for(size_t t = 0; t < PATCH_TARGETS; t++)
+                         {
+                           while((patched = edits->take (t, patch_index->data, patch_value->data)) > 0)
+                           {
+                             if(cpu)
+                             {
+                               for(size_t p = 0; p < patched; p++)
+                               {
+                                 if(t == PATCH_FREE)
+                                 {
+                                   freedom->data[patch_index->data[p]] = (int)patch_value->data[p]; // Setting freedom flag...
+                                 }
+                                 else
+                                 {
+                                   stiffness->data[patch_index->data[p]] = patch_value->data[p];    // Setting link stiffness...
+                                 }
+                               }
+                             }
+                             else
+                             {
+                               patch->data = {(int)t, (int)patched};                                // Setting patch parameters...
+                               cl->write (31);                                                      // Writing patch indices...
+                               cl->write (32);                                                      // Writing patch values...
+                               cl->write (33);                                                      // Writing patch parameters...
+                               cl->execute (K11, NU_WAIT);                                          // Executing OpenCL kernel (patch scatter)...
+                             }
+                           }
+                         }
+                       };
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////////////// PARAMETER SWEEP ////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Each point of the sweep grid sets its parameters and derives node mass, link stiffness, damping
+  // and time step again: only the parameter buffers whose values have changed are written to the
+  // device, the mesh, the kernels and all other buffers being those of the start-up. The point runs
+  // "sweep_steps" steps from the initial state and is summed up by the watchdog reductions.
+  if(points > 0)
+  {
+    sweep_log.open (SWEEP_LOG);                                                                     // Opening sweep results table...
+    sweep_log << "point,parameters,dt,steps,step_us,kinetic,elastic,strain,non_finite,uploads"
+              << std::endl;                                                                         // Writing header...
+
+    for(i = 0; i < points; i++)
+    {
+      sweep_point = settings->point (i);                                                            // Setting sweep point...
+      physics ();                                                                                   // Computing physical parameters...
+      uploads     = 0;                                                                              // Resetting uploads...
+
+      if(m != mass->data[0])
+      {
+        mass->data.assign (nodes, m);                                                               // Setting mass...
+        cl->write (10);                                                                             // Writing mass...
+        uploads++;                                                                                  // Counting upload...
+      }
+
+      if(K != contact->data[2])
+      {
+        stiffness->data.assign (stiffness->data.size (), K);                                        // Setting link stiffness...
+        contact->data[2] = K;                                                                       // Setting contact stiffness...
+        cl->write (7);                                                                              // Writing link stiffness...
+        cl->write (21);                                                                             // Writing contact parameters...
+        uploads += 2;                                                                               // Counting uploads...
+      }
+
+      if(B != friction->data[0])
+      {
+        friction->data[0] = B;                                                                      // Setting friction...
+        cl->write (9);                                                                              // Writing friction...
+        uploads++;                                                                                  // Counting upload...
+      }
+
+      if(-g != gravity->data[0].z)
+      {
+        gravity->data[0].z = -g;                                                                    // Setting gravity...
+        cl->write (6);                                                                              // Writing gravity...
+        uploads++;                                                                                  // Counting upload...
+      }
+
+      if(dt_simulation != dt->data[0])
+      {
+        dt->data[0] = dt_simulation;                                                                // Setting simulation time step...
+        cl->write (14);                                                                             // Writing simulation time step...
+        uploads++;                                                                                  // Counting upload...
+      }
+
       position->data     = initial_position;                                                        // Restoring backup...
       position_int->data = initial_position_int;                                                    // Restoring backup...
       velocity->data     = initial_velocity;                                                        // Restoring backup...
       velocity_int->data = initial_velocity_int;                                                    // Restoring backup...
       acceleration->data = initial_acceleration;                                                    // Restoring backup...
+      pack_state ();                                                                                // Packing state...
       cl->write (1);                                                                                // Writing data...
       cl->write (2);                                                                                // Writing data...
       cl->write (3);                                                                                // Writing data...
       cl->write (4);                                                                                // Writing data...
       cl->write (5);                                                                                // Writing data...
+
+      auto t0 = std::chrono::steady_clock::now ();                                                  // Sweep point start.
+
+      for(j = 0; j < sweep_steps; j++)
+      {
+        cl->execute (K1, NU_WAIT);                                                                  // Executing OpenCL kernel (predictor)...
+        cl->execute (K3, NU_WAIT);                                                                  // Executing OpenCL kernel (grid clear)...
+        cl->execute (K4, NU_WAIT);                                                                  // Executing OpenCL kernel (grid nodes)...
+        cl->execute (K5, NU_WAIT);                                                                  // Executing OpenCL kernel (grid triangles)...
+        cl->execute (K6, NU_WAIT);                                                                  // Executing OpenCL kernel (contact)...
+        corrector ();                                                                               // Executing OpenCL kernels (corrector)...
+      }
+
+      auto t1 = std::chrono::steady_clock::now ();                                                  // Sweep point end.
+      cl->execute (K7, NU_WAIT);                                                                    // Executing OpenCL kernel (watchdog groups)...
+      cl->execute (K8, NU_WAIT);                                                                    // Executing OpenCL kernel (watchdog sum)...
+      cl->read (24);                                                                                // Reading watchdog reductions...
+      step_time = std::chrono::duration<double, std::micro>(t1 - t0).count ()/sweep_steps;          // Computing step time...
+
+      sweep_log << i << "," << sweep_point << "," << dt_simulation << "," << sweep_steps << ","
+                << step_time << "," << watch->data[0] << "," << watch->data[1] << ","
+                << watch->data[5] << "," << watch->data[6] << "," << uploads << std::endl;          // Logging sweep point...
+      std::cout << "sweep point " << i << " (" << sweep_point << "): dt = " << dt_simulation
+                << " s, step = " << step_time << " us, kinetic = " << watch->data[0]
+                << ", elastic = " << watch->data[1] << ", max strain = " << watch->data[5]
+                << ", non-finite = " << watch->data[6] << ", uploads = " << uploads
+                << std::endl;                                                                       // Printing message...
+    }
+
+    running = false;                                                                                // Leaving simulation thread idle...
+    gl->close ();                                                                                   // Skipping application loop...
+  }
+
+  // WATCHDOG TIME SERIES (OpenCL backend):
+  if(!cpu && (points == 0))
+  {
+    watch_log.open (WATCH_LOG);                                                                     // Opening watchdog log...
+    watch_log << "step,dt,kinetic,elastic,momentum_x,momentum_y,momentum_z,strain,non_finite,action"
+              << std::endl;                                                                         // Writing header...
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////////////// SIMULATION THREAD ////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  // The simulation thread owns the OpenCL queue and buffers (or runs the CPU solver): it publishes a
+  // snapshot of the node positions and link colors each time the renderer has taken the previous
+  // one. The OpenCL buffers are not shared with OpenGL (INTEROP = false): the renderer only draws
+  // the host snapshots, so that no OpenGL object is ever acquired from this thread. The snapshot is
+  // read back only on the steps that publish it, but Neutrino's read is blocking: those steps wait
+  // for the queue to drain and for the whole color (RGBA8) and position (float4) buffers to be
+  // copied, which shows in their step time. Waits block on condition variables instead of
+  // spinning. Every WATCH_STEPS steps the watchdog reduces the state on the device: a healthy state
+  // is checkpointed on the device, a diverged one can be rolled back to the last checkpoint with a
+  // halved time step (once: if it diverges again from there the run is halted) or halted.
+  simulation = std::thread ([&] ()
+  {
+    while(running)
+    {
+      if(halted && !reset)
+      {
+        std::this_thread::sleep_for (std::chrono::milliseconds (10));                               // Waiting for reset...
+        continue;
+      }
+
+      if(lockstep && (step >= granted))
+      {
+        std::unique_lock<std::mutex> guard (grant_lock);
+
+        grant_signal.wait_for (
+                               guard,
+                               std::chrono::milliseconds (10),
+                               [&]{return step < granted;}
+                              );                                                                    // Waiting for the next frame to grant its steps...
+        continue;
+      }
+
+      if(record && frames.pending ())
+      {
+        frames.wait_taken (std::chrono::milliseconds (10));                                         // Waiting for the recorder to take the last snapshot...
+        continue;
+      }
+
+      if(reset)
+      {
+        position->data     = initial_position;                                                      // Restoring backup...
+        position_int->data = initial_position_int;                                                  // Restoring backup...
+        velocity->data     = initial_velocity;                                                      // Restoring backup...
+        velocity_int->data = initial_velocity_int;                                                  // Restoring backup...
+        acceleration->data = initial_acceleration;                                                  // Restoring backup...
+        stiffness->data    = initial_stiffness;                                                     // Restoring backup...
+        freedom->data      = initial_freedom;                                                       // Restoring backup...
+        dt->data[0]        = dt_simulation;                                                         // Restoring time step (halved by rollbacks)...
+        edits->clear ();                                                                            // Dropping queued patches...
+
+        if(!cpu)
+        {
+          pack_state ();                                                                            // Packing state...
+          cl->write (1);                                                                            // Writing data...
+          cl->write (2);                                                                            // Writing data...
+          cl->write (3);                                                                            // Writing data...
+          cl->write (4);                                                                            // Writing data...
+          cl->write (5);                                                                            // Writing data...
+          cl->write (7);                                                                            // Writing data...
+          cl->write (13);                                                                           // Writing data...
+          cl->write (14);                                                                           // Writing data...
+          cl->execute (K9, NU_WAIT);                                                                // Executing OpenCL kernel (checkpoint)...
+        }
+
+        halted = false;                                                                             // Resuming run...
+        rolled = false;                                                                             // Resetting rollback...
+        reset  = false;                                                                             // Resetting request...
+      }
+
+      if(lockstep)
+      {
+        publishing = ((step + 1) == granted);                                                       // Publishing at the end of the frame steps...
+      }
+      else
+      {
+        publishing = !frames.pending () && (!record || (((step + 1) % RECORD_STEPS) == 0));         // Publishing when taken...
+      }
+
+      if(cpu)
+      {
+        apply_patches ();                                                                           // Applying patches...
+        solver->step ();                                                                            // Advancing CPU solver...
+        step++;                                                                                     // Advancing step...
+      }
+      else
+      {
+        cl->get_tic ();                                                                             // Getting "tic" [us]...
+        apply_patches ();                                                                           // Applying patches...
+        cl->execute (K1, NU_WAIT);                                                                  // Executing OpenCL kernel (predictor)...
+
+        auto t0 = std::chrono::steady_clock::now ();                                                // Grid build start.
+        cl->execute (K3, NU_WAIT);                                                                  // Executing OpenCL kernel (grid clear)...
+        cl->execute (K4, NU_WAIT);                                                                  // Executing OpenCL kernel (grid nodes)...
+        cl->execute (K5, NU_WAIT);                                                                  // Executing OpenCL kernel (grid triangles)...
+        auto t1 = std::chrono::steady_clock::now ();                                                // Grid build end, query start.
+        cl->execute (K6, NU_WAIT);                                                                  // Executing OpenCL kernel (contact)...
+        auto t2 = std::chrono::steady_clock::now ();                                                // Grid query end.
+
+        corrector (&bucket_time);                                                                   // Executing OpenCL kernels (corrector)...
+        auto t3 = std::chrono::steady_clock::now ();                                                // Corrector end.
+
+        if(((step + 1) % WATCH_STEPS) == 0)
+        {
+          cl->execute (K7, NU_WAIT);                                                                // Executing OpenCL kernel (watchdog groups)...
+          cl->execute (K8, NU_WAIT);                                                                // Executing OpenCL kernel (watchdog sum)...
+          cl->read (24);                                                                            // Reading watchdog reductions...
+          diverged = (watch->data[6] > 0.0f) || (watch->data[5] > WATCH_STRAIN);                    // Checking divergence...
+
+          if(!diverged)
+          {
+            cl->execute (K9, NU_WAIT);                                                              // Executing OpenCL kernel (checkpoint)...
+            rolled       = false;                                                                   // Resetting rollback...
+            watch_action = "checkpoint";                                                            // Setting action...
+          }
+          else if(rollback && !rolled)
+          {
+            cl->execute (K10, NU_WAIT);                                                             // Executing OpenCL kernel (rollback)...
+            dt->data[0] *= 0.5f;                                                                    // Halving time step (not to diverge again)...
+            cl->write (14);                                                                         // Writing simulation time step...
+            rolled       = true;                                                                    // Setting rollback...
+            watch_action = "rollback";                                                              // Setting action...
+          }
+          else if(halt || rollback)
+          {
+            halted       = true;                                                                    // Halting run...
+            watch_action = "halt";                                                                  // Setting action...
+          }
+          else
+          {
+            watch_action = "none";                                                                  // Setting action...
+          }
+
+          watch_log << step + 1 << "," << dt->data[0] << "," << watch->data[0] << ","
+                    << watch->data[1] << "," << watch->data[2] << "," << watch->data[3] << ","
+                    << watch->data[4] << "," << watch->data[5] << "," << watch->data[6] << ","
+                    << watch_action << std::endl;                                                   // Logging watchdog reductions...
+
+          if(diverged)
+          {
+            std::cout << "watchdog: divergence at step " << step + 1 << " (max strain = "
+                      << watch->data[5] << ", non-finite = " << watch->data[6] << "), action = "
+                      << watch_action << ", dt = " << dt->data[0] << " s" << std::endl;             // Printing message...
+          }
+        }
+
+        if(publishing)
+        {
+          cl->read (0);                                                                             // Reading color (blocking, publish steps only)...
+          cl->read (1);                                                                             // Reading position (blocking, publish steps only)...
+        }
+
+        cl->get_toc ();                                                                             // Getting "toc" [us]...
+        step++;                                                                                     // Advancing step...
+        build_time += std::chrono::duration<double, std::micro>(t1 - t0).count ();                  // Accumulating grid build time...
+        query_time += std::chrono::duration<double, std::micro>(t2 - t1).count ();                  // Accumulating grid query time...
+        corr_time  += std::chrono::duration<double, std::micro>(t3 - t2).count ();                  // Accumulating corrector time...
+
+        if((step % PROFILE_STEPS) == 0)
+        {
+          std::cout << "grid build = " << build_time/PROFILE_STEPS << " us, "
+                    << "grid query = " << query_time/PROFILE_STEPS << " us, "
+                    << "corrector = " << corr_time/PROFILE_STEPS << " us" << std::endl;             // Printing profiler report...
+
+          for(size_t b = 0; b < bucket_time.size (); b++)
+          {
+            std::cout << "bucket " << b << " (degree = " << node_buckets->degree[b] << "): "
+                      << bucket_time[b]/PROFILE_STEPS << " us/dispatch" << std::endl;               // Printing profiler report (per dispatch)...
+            bucket_time[b] = 0.0;                                                                   // Resetting dispatch time...
+          }
+          cl->read (22);                                                                            // Reading grid overflow counters...
+
+          if((grid->data[5] > 0) || (grid->data[6] > 0))
+          {
+            std::cout << "grid overflow: nodes = " << grid->data[5] << ", triangles = "
+                      << grid->data[6] << " (contacts lost in the last " << PROFILE_STEPS
+                      << " steps)" << std::endl;                                                    // Printing message...
+            grid->data[5] = 0;                                                                      // Resetting node overflow counter...
+            grid->data[6] = 0;                                                                      // Resetting triangle overflow counter...
+            cl->write (22);                                                                         // Writing grid parameters...
+          }
+
+          build_time = 0.0;                                                                         // Resetting grid build time...
+          query_time = 0.0;                                                                         // Resetting grid query time...
+          corr_time  = 0.0;                                                                         // Resetting corrector time...
+        }
+      }
+
+      if(publishing)
+      {
+        frames.write_buffer ().color    = color->data;                                              // Setting snapshot color...
+        frames.write_buffer ().position = position->data;                                           // Setting snapshot position...
+        frames.write_buffer ().step     = step;                                                     // Setting snapshot step...
+        frames.publish ();                                                                          // Publishing snapshot...
+      }
+    }
+  });
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////////////// APPLICATION LOOP /////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  draw_color->upload (color->data);                                                                 // Uploading initial color...
+  draw_position->upload (position->data);                                                           // Uploading initial position...
+  draw_offset->upload (offset->data);                                                               // Uploading neighbour offsets...
+  draw_nearest->upload (neighbour->data);                                                           // Uploading neighbour nodes...
+
+  while(!gl->closed ())                                                                             // Opening window...
+  {
+    auto f0 = std::chrono::steady_clock::now ();                                                    // Frame start.
+    fresh   = frames.take ();                                                                       // Taking latest snapshot...
+
+    while(lockstep && !fresh)
+    {
+      frames.wait_published (std::chrono::milliseconds (10));                                       // Waiting for the frame steps...
+      fresh = frames.take ();                                                                       // Taking frame snapshot...
+    }
+
+    auto f1 = std::chrono::steady_clock::now ();                                                    // Frame compute end.
+
+    if(fresh)
+    {
+      draw_color->upload (frames.read_buffer ().color);                                             // Uploading latest color...
+      draw_position->upload (frames.read_buffer ().position);                                       // Uploading latest position...
+    }
+
+    if(fresh && (video != nullptr))
+    {
+      video->bind ();                                                                               // Rendering offscreen...
+    }
+
+    gl->clear ();                                                                                   // Clearing gl...
+    gl->poll_events ();                                                                             // Polling gl events...
+
+    if(!replay)
+    {
+      gl->mouse_navigation (ms_orbit_rate, ms_pan_rate, ms_decaytime);                              // Polling mouse...
+      gl->gamepad_navigation (gmp_orbit_rate, gmp_pan_rate, gmp_decaytime, gmp_deadzone);           // Polling gamepad...
+    }
+
+    gl->plot (S);                                                                                   // Plotting shared arguments...
+
+    // FRAME INPUT (live, or read from the input log):
+    if(replay)
+    {
+      if(!inputs->read (now))
+      {
+        now.cross = true;                                                                           // Ending replay (end of log)...
+      }
+
+      links->camera (now.camera);                                                                   // Setting logged camera...
+    }
+    else
+    {
+      now.cross    = gl->button_CROSS;                                                              // Getting "CROSS" button...
+      now.triangle = gl->button_TRIANGLE;                                                           // Getting "TRIANGLE" button...
+      now.circle   = gl->button_CIRCLE;                                                             // Getting "CIRCLE" button...
+      now.square   = gl->button_SQUARE;                                                             // Getting "SQUARE" button...
+      now.camera   = links->camera ();                                                              // Getting camera...
+
+      if(capture)
+      {
+        inputs->write (now);                                                                        // Logging frame input...
+      }
+    }
+
+    links->plot (nodes, neighbours);                                                                // Plotting links...
+
+    if(fresh && (video != nullptr))
+    {
+      video->capture ();                                                                            // Reading frame back (asynchronously)...
+    }
+
+    if(lockstep)
+    {
+      glFinish ();                                                                                  // Waiting for the frame to be rendered...
     }
 
-    cl->get_toc ();                                                                                 // Getting "toc" [us]...
+    gl->refresh ();                                                                                 // Refreshing gl...
+
+    if(now.cross)
+    {
+      gl->close ();                                                                                 // Closing gl...
+    }
+
+    if(now.triangle)
+    {
+      reset     = true;                                                                             // Requesting reset...
+      pinned    = false;                                                                            // Resetting patch region...
+      stiffened = false;                                                                            // Resetting patch region...
+    }
+
+    // PATCHING REGION ("CIRCLE" = pin/release, "SQUARE" = stiffen/soften):
+    if(now.circle && !circle)
+    {
+      pinned = !pinned;                                                                             // Toggling pin...
+
+      for(int n : region_node)
+      {
+        edits->set (PATCH_FREE, n, pinned ? 0.0f : (float)initial_freedom[n]);                      // Queueing freedom flag...
+      }
+    }
+
+    if(now.square && !square)
+    {
+      stiffened = !stiffened;                                                                       // Toggling stiffening...
+
+      for(int l : region_link)
+      {
+        edits->set (PATCH_STIFF, l, initial_stiffness[l]*(stiffened ? PATCH_GAIN : 1.0f));          // Queueing link stiffness...
+      }
+    }
+
+    circle = now.circle;                                                                            // Storing button state...
+    square = now.square;                                                                            // Storing button state...
+
+    // FRAME TIMING AND NEXT FRAME STEPS (lockstep):
+    if(lockstep)
+    {
+      auto f2 = std::chrono::steady_clock::now ();                                                  // Frame end.
+
+      timing_log << frame << "," << frames.read_buffer ().step << ","
+                 << std::chrono::duration<double, std::micro>(f1 - f0).count () << ","
+                 << std::chrono::duration<double, std::micro>(f2 - f1).count () << ","
+                 << std::chrono::duration<double, std::micro>(f2 - f0).count () << std::endl;       // Logging frame timing...
+      frame_total += std::chrono::duration<double, std::micro>(f2 - f0).count ();                   // Accumulating frame time...
+      frame++;                                                                                      // Advancing frame...
+
+      {
+        std::lock_guard<std::mutex> guard (grant_lock);
+
+        granted += FRAME_STEPS;                                                                     // Granting next frame steps...
+      }
+
+      grant_signal.notify_one ();                                                                   // Waking simulation...
+    }
+  }
+
+  running = false;                                                                                  // Stopping simulation...
+  simulation.join ();                                                                               // Waiting for simulation thread...
+
+  if(lockstep && (frame > 0))
+  {
+    std::cout << "frames = " << frame << ", mean frame time = " << frame_total/frame << " us ("
+              << FRAME_STEPS << " steps/frame)" << std::endl;                                       // Printing message...
   }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////// CLEANUP /////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
+  if(video != nullptr)
+  {
+    std::cout << "recorded frames = " << video->frames () << std::endl;                             // Printing message...
+    delete video;                                                                                   // Deleting frame recorder (writing the last frames)...
+  }
+
   delete cl;                                                                                        // Deleting OpenCL context...
   delete gl;                                                                                        // Deleting OpenGL context...
   delete S;                                                                                         // Deleting shader...
+  delete links;                                                                                     // Deleting link renderer...
+  delete draw_color;                                                                                // Deleting color storage...
+  delete draw_position;                                                                             // Deleting position storage...
+  delete draw_offset;                                                                               // Deleting offset storage...
+  delete draw_nearest;                                                                              // Deleting neighbour storage...
   delete color;                                                                                     // Deleting color data...
   delete position;                                                                                  // Deleting position data...
   delete position_int;                                                                              // Deleting intermediate position data...
@@ -323,14 +1530,57 @@ int main ()
   delete resting;                                                                                   // Deleting resting data...
   delete friction;                                                                                  // Deleting friction data...
   delete mass;                                                                                      // Deleting mass data...
-  delete central;                                                                                   // Deleting centrals...
   delete neighbour;                                                                                 // Deleting neighbours...
   delete offset;                                                                                    // Deleting offset...
   delete freedom;                                                                                   // Deleting freedom flag data...
   delete dt;                                                                                        // Deleting time step data...
   delete K1;                                                                                        // Deleting OpenCL kernel...
   delete K2;                                                                                        // Deleting OpenCL kernel...
+  delete K3;                                                                                        // Deleting OpenCL kernel...
+  delete K4;                                                                                        // Deleting OpenCL kernel...
+  delete K5;                                                                                        // Deleting OpenCL kernel...
+  delete K6;                                                                                        // Deleting OpenCL kernel...
+  delete K7;                                                                                        // Deleting OpenCL kernel...
+  delete K8;                                                                                        // Deleting OpenCL kernel...
+  delete K9;                                                                                        // Deleting OpenCL kernel...
+  delete K10;                                                                                       // Deleting OpenCL kernel...
+  delete K11;                                                                                       // Deleting OpenCL kernel...
+  delete K1_alt;                                                                                    // Deleting OpenCL kernel...
+  delete K2_alt;                                                                                    // Deleting OpenCL kernel...
+  delete K4_alt;                                                                                    // Deleting OpenCL kernel...
+  delete K5_alt;                                                                                    // Deleting OpenCL kernel...
+  delete K6_alt;                                                                                    // Deleting OpenCL kernel...
+
+  for(i = 0; i < K2_bucket.size (); i++)
+  {
+    delete K2_bucket[i];                                                                            // Deleting OpenCL kernel...
+  }
+
+  delete cell_count;                                                                                // Deleting grid cell node counters...
+  delete cell_node;                                                                                 // Deleting grid cell nodes...
+  delete cell_tri_count;                                                                            // Deleting grid cell triangle counters...
+  delete cell_triangle;                                                                             // Deleting grid cell triangles...
+  delete triangle;                                                                                  // Deleting triangles...
+  delete contact_force;                                                                             // Deleting contact forces...
+  delete contact;                                                                                   // Deleting contact parameters...
+  delete grid;                                                                                      // Deleting grid parameters...
+  delete watch_partial;                                                                             // Deleting watchdog partial reductions...
+  delete watch;                                                                                     // Deleting watchdog reductions...
+  delete watchdog;                                                                                  // Deleting watchdog parameters...
+  delete ckpt_position;                                                                             // Deleting position checkpoint...
+  delete ckpt_velocity;                                                                             // Deleting velocity checkpoint...
+  delete ckpt_accel;                                                                                // Deleting acceleration checkpoint...
+  delete bucket_node;                                                                               // Deleting bucket nodes...
+  delete bucket;                                                                                    // Deleting bucket parameters...
+  delete patch_index;                                                                               // Deleting patch indices...
+  delete patch_value;                                                                               // Deleting patch values...
+  delete patch;                                                                                     // Deleting patch parameters...
   delete cloth;                                                                                     // deleting cloth mesh...
+  delete node_buckets;                                                                              // Deleting degree buckets...
+  delete edits;                                                                                     // Deleting patches...
+  delete inputs;                                                                                    // Deleting input log...
+  delete solver;                                                                                    // Deleting CPU solver...
+  delete settings;                                                                                  // Deleting configuration...
 
   return 0;
 }
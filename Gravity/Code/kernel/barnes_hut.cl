@@ -0,0 +1,100 @@
+/// @file
+/// @brief    Barnes-Hut: opening-angle tree traversal (one work-item per leaf).
+/// @details  Along any path of the radix tree the common prefix length of the node ranges strictly
+///           increases, from 0 up to 63 (30-bit codes, ties broken by the 32-bit index): the tree
+///           is at most 64 levels deep and a depth-first traversal, which keeps at most one
+///           pending sibling per level plus the two children just pushed, never holds more than
+///           66 entries.
+
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position,                                 // Position [m].
+                        __global float4*    velocity,                                 // Velocity [m/s].
+                        __global float4*    acceleration,                             // Acceleration [m/s^2].
+                        __global float4*    position_int,                             // Position (intermediate) [m].
+                        __global float4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       central,                                  // Node.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global int*       morton,                                   // Morton codes (sorted).
+                        __global int*       sorted,                                   // Node indices (sorted by Morton code).
+                        __global int*       tree_child,                               // Tree children.
+                        __global int*       tree_parent,                              // Tree parents.
+                        __global float4*    tree_mass,                                // Tree centers of mass [m] and masses [kg].
+                        __global float4*    tree_box,                                 // Tree bounding boxes [m].
+                        __global int*       tree_flag,                                // Tree visit counters.
+                        __global float4*    field,                                    // Mutual gravitational force [N].
+                        __global float*     gravitation,                              // Gravitation parameters.
+                        __global int*       sort_pass,                                // Sorting pass parameters.
+                        __global float4*    position_lo,                              // Position (compensation) [m].
+                        __global int*       bucket_node,                              // Nodes (sorted by degree).
+                        __global int*       bucket)                                   // Bucket parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  int          k = get_global_id(0);                                            // Leaf index (sorted order) [#].
+  int          n = sort_pass[2];                                                // Number of leaves [#].
+  int          node = sorted[k];                                                // Mesh node index.
+  int          stack[66];                                                       // Traversal stack (tree depth + 2).
+  int          top = 0;                                                         // Stack top.
+  int          u;                                                               // Tree node (unified index).
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  float4        p                 = position_int[node];                         // Node position.
+  float         G                 = gravitation[0];                             // Gravitational constant.
+  float         theta             = gravitation[1];                             // Opening angle.
+  float         eps               = gravitation[2];                             // Softening length [m].
+  float3        F                 = (float3)(0.0f, 0.0f, 0.0f);                 // Force (per unit masses).
+  float4        M;                                                              // Tree node mass.
+  float3        D;                                                              // Separation.
+  float3        lo;                                                             // Tree node box minimum.
+  float3        hi;                                                             // Tree node box maximum.
+  float         r2;                                                             // Squared distance (softened).
+  float         size;                                                           // Tree node size.
+
+  stack[top++] = (n > 1) ? 0 : (n - 1);                                         // Pushing root...
+
+  while (top > 0)
+  {
+    u = stack[--top];                                                           // Popping node...
+    M = tree_mass[u];                                                           // Getting node mass...
+    D = M.xyz - p.xyz;                                                          // Computing separation...
+    r2 = dot(D, D) + eps*eps;                                                   // Computing softened distance...
+
+    if (u >= (n - 1))
+    {
+      // LEAF (direct interaction):
+      if (u != (n - 1 + k))
+      {
+        F += M.w*D/(r2*sqrt(r2));                                               // Building up force...
+      }
+    }
+    else
+    {
+      lo = tree_box[2*u + 0].xyz;                                               // Getting box minimum...
+      hi = tree_box[2*u + 1].xyz;                                               // Getting box maximum...
+      size = max(hi.x - lo.x, max(hi.y - lo.y, hi.z - lo.z));                   // Computing node size...
+
+      if (((size*size) < (theta*theta*r2)) && any(p.xyz < lo || p.xyz > hi))
+      {
+        F += M.w*D/(r2*sqrt(r2));                                               // Building up force (far node)...
+      }
+      else
+      {
+        stack[top++] = tree_child[2*u + 0];                                     // Opening node (left)...
+        stack[top++] = tree_child[2*u + 1];                                     // Opening node (right)...
+      }
+    }
+  }
+
+  field[node] = (float4)(G*mass[node]*F, 1.0f);                                 // Storing gravitational force...
+}
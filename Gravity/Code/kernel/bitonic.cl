@@ -0,0 +1,78 @@
+/// @file
+/// @brief    Barnes-Hut: bitonic sorting pass (one work-item per padded node).
+/// @details  The (sequence size, compare distance) pairs of all passes are set once in "sort_pass"
+///           (from [5] on): the pass reads its pair at index sort_pass[0], and the last work-item
+///           to finish moves that index to the next pass (wrapping to 0 after the last one), so
+///           that the passes of a sort need no parameter write from the host.
+
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position,                                 // Position [m].
+                        __global float4*    velocity,                                 // Velocity [m/s].
+                        __global float4*    acceleration,                             // Acceleration [m/s^2].
+                        __global float4*    position_int,                             // Position (intermediate) [m].
+                        __global float4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       central,                                  // Node.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global int*       morton,                                   // Morton codes (sorted).
+                        __global int*       sorted,                                   // Node indices (sorted by Morton code).
+                        __global int*       tree_child,                               // Tree children.
+                        __global int*       tree_parent,                              // Tree parents.
+                        __global float4*    tree_mass,                                // Tree centers of mass [m] and masses [kg].
+                        __global float4*    tree_box,                                 // Tree bounding boxes [m].
+                        __global int*       tree_flag,                                // Tree visit counters.
+                        __global float4*    field,                                    // Mutual gravitational force [N].
+                        __global float*     gravitation,                              // Gravitation parameters.
+                        __global int*       sort_pass,                                // Sorting pass parameters.
+                        __global float4*    position_lo,                              // Position (compensation) [m].
+                        __global int*       bucket_node,                              // Nodes (sorted by degree).
+                        __global int*       bucket)                                   // Bucket parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i = get_global_id(0);                                            // Global index [#].
+  int          pass = sort_pass[0];                                             // Sorting pass [#].
+  unsigned int k = sort_pass[5 + 2*pass];                                       // Bitonic sequence size.
+  unsigned int j = sort_pass[6 + 2*pass];                                       // Compare distance.
+  unsigned int l = i ^ j;                                                       // Partner index.
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  uint          a;                                                              // Code "i".
+  uint          b;                                                              // Code "l".
+  int           s;                                                              // Swap buffer.
+  bool          up;                                                             // Ascending flag.
+
+  // COMPARING AND EXCHANGING:
+  if (l > i)
+  {
+    a = (uint)morton[i];                                                        // Getting code "i"...
+    b = (uint)morton[l];                                                        // Getting code "l"...
+    up = ((i & k) == 0);                                                        // Getting direction...
+
+    if ((a > b) == up)
+    {
+      morton[i] = (int)b;                                                       // Swapping codes...
+      morton[l] = (int)a;                                                       // Swapping codes...
+      s = sorted[i];                                                            // Swapping indices...
+      sorted[i] = sorted[l];                                                    // Swapping indices...
+      sorted[l] = s;                                                            // Swapping indices...
+    }
+  }
+
+  // ADVANCING PASS (last work-item to finish):
+  if (atomic_inc(&sort_pass[1]) == (int)(get_global_size(0) - 1))
+  {
+    sort_pass[1] = 0;                                                           // Resetting finished work-items...
+    sort_pass[0] = (pass + 1)%sort_pass[4];                                     // Moving to next pass...
+  }
+}
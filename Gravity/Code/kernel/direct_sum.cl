@@ -0,0 +1,62 @@
+/// @file
+/// @brief    Barnes-Hut: direct-sum reference (one work-item per node, O(n^2)).
+
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position,                                 // Position [m].
+                        __global float4*    velocity,                                 // Velocity [m/s].
+                        __global float4*    acceleration,                             // Acceleration [m/s^2].
+                        __global float4*    position_int,                             // Position (intermediate) [m].
+                        __global float4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       central,                                  // Node.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global int*       morton,                                   // Morton codes (sorted).
+                        __global int*       sorted,                                   // Node indices (sorted by Morton code).
+                        __global int*       tree_child,                               // Tree children.
+                        __global int*       tree_parent,                              // Tree parents.
+                        __global float4*    tree_mass,                                // Tree centers of mass [m] and masses [kg].
+                        __global float4*    tree_box,                                 // Tree bounding boxes [m].
+                        __global int*       tree_flag,                                // Tree visit counters.
+                        __global float4*    field,                                    // Mutual gravitational force [N].
+                        __global float*     gravitation,                              // Gravitation parameters.
+                        __global int*       sort_pass,                                // Sorting pass parameters.
+                        __global float4*    position_lo,                              // Position (compensation) [m].
+                        __global int*       bucket_node,                              // Nodes (sorted by degree).
+                        __global int*       bucket)                                   // Bucket parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  int          i = get_global_id(0);                                            // Global index [#].
+  int          j;                                                               // Other node index [#].
+  int          n = sort_pass[2];                                                // Number of nodes [#].
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  float4        p                 = position_int[i];                            // Node position.
+  float         G                 = gravitation[0];                             // Gravitational constant.
+  float         eps               = gravitation[2];                             // Softening length [m].
+  float3        F                 = (float3)(0.0f, 0.0f, 0.0f);                 // Force (per unit masses).
+  float3        D;                                                              // Separation.
+  float         r2;                                                             // Squared distance (softened).
+
+  for (j = 0; j < n; j++)
+  {
+    if (j != i)
+    {
+      D = position_int[j].xyz - p.xyz;                                          // Computing separation...
+      r2 = dot(D, D) + eps*eps;                                                 // Computing softened distance...
+      F += mass[j]*D/(r2*sqrt(r2));                                             // Building up force...
+    }
+  }
+
+  field[i] = (float4)(G*mass[i]*F, 1.0f);                                       // Storing gravitational force...
+}
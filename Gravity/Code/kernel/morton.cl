@@ -0,0 +1,57 @@
+/// @file
+/// @brief    Barnes-Hut: Morton codes (one work-item per padded node).
+
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position,                                 // Position [m].
+                        __global float4*    velocity,                                 // Velocity [m/s].
+                        __global float4*    acceleration,                             // Acceleration [m/s^2].
+                        __global float4*    position_int,                             // Position (intermediate) [m].
+                        __global float4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       central,                                  // Node.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global int*       morton,                                   // Morton codes (sorted).
+                        __global int*       sorted,                                   // Node indices (sorted by Morton code).
+                        __global int*       tree_child,                               // Tree children.
+                        __global int*       tree_parent,                              // Tree parents.
+                        __global float4*    tree_mass,                                // Tree centers of mass [m] and masses [kg].
+                        __global float4*    tree_box,                                 // Tree bounding boxes [m].
+                        __global int*       tree_flag,                                // Tree visit counters.
+                        __global float4*    field,                                    // Mutual gravitational force [N].
+                        __global float*     gravitation,                              // Gravitation parameters.
+                        __global int*       sort_pass,                                // Sorting pass parameters.
+                        __global float4*    position_lo,                              // Position (compensation) [m].
+                        __global int*       bucket_node,                              // Nodes (sorted by degree).
+                        __global int*       bucket)                                   // Bucket parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  unsigned int i = get_global_id(0);                                            // Global index [#].
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  int           n                 = sort_pass[2];                               // Number of nodes [#].
+  float         box_min           = gravitation[4];                             // Domain box minimum [m].
+  float         box_size          = gravitation[5];                             // Domain box size [m].
+
+  // COMPUTING MORTON CODE:
+  if (i < (unsigned int)n)
+  {
+    morton[i] = (int)morton_code((position_int[i].xyz - box_min)/box_size);     // Computing node code...
+  }
+  else
+  {
+    morton[i] = -1;                                                             // Padding (0xFFFFFFFF, sorted last)...
+  }
+
+  sorted[i] = i;                                                                // Resetting node index...
+}
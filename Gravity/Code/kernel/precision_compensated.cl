@@ -0,0 +1,17 @@
+/// @file     precision_compensated.cl
+/// @brief    Position update (compensated single precision).
+/// @details  The rounding error of each position update is kept in the compensation buffer and
+/// carried into the next step (Kahan summation, with Knuth's two-sum for the error), hence small
+/// steps (e.g. at 0.02*dt_critical) keep accumulating instead of being rounded away. The kernels
+/// must not be built with "-cl-fast-relaxed-math" (it would simplify the error terms to zero).
+
+float4 advance_position (float4 p, float4 dp, __global float4* position_lo, unsigned int i)
+{
+  float4 y = dp + position_lo[i];                                               // Step plus carried error.
+  float4 s = p + y;                                                             // Rounded sum.
+  float4 b = s - p;                                                             // Rounded step.
+
+  position_lo[i] = (p - (s - b)) + (y - b);                                     // Storing rounding error...
+
+  return s;
+}
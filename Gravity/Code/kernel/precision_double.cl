@@ -0,0 +1,20 @@
+/// @file     precision_double.cl
+/// @brief    Position update (double precision).
+/// @details  The position is kept as the unevaluated sum of the single precision position and of
+/// its compensation ("double-float", about 48 significant bits) and updated in double precision:
+/// it needs a device supporting "cl_khr_fp64".
+
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+
+float4 advance_position (float4 p, float4 dp, __global float4* position_lo, unsigned int i)
+{
+  double4 x = convert_double4(p) + convert_double4(position_lo[i]);             // Position.
+  float4  s;                                                                    // Rounded position.
+
+  x += convert_double4(dp);                                                     // Advancing position...
+  s  = convert_float4(x);                                                       // Rounding position...
+
+  position_lo[i] = convert_float4(x - convert_double4(s));                      // Storing rounding error...
+
+  return s;
+}
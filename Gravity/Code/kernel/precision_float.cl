@@ -0,0 +1,9 @@
+/// @file     precision_float.cl
+/// @brief    Position update (single precision).
+/// @details  The position step is added in single precision: steps smaller than half a unit in
+/// the last place of the position are lost. The compensation buffer is not used.
+
+float4 advance_position (float4 p, float4 dp, __global float4* position_lo, unsigned int i)
+{
+  return p + dp;                                                                // Advancing position...
+}
@@ -15,7 +15,20 @@ __kernel void thekernel(__global float4*    color,
                         __global int*       nearest,                                  // Neighbour.
                         __global int*       offset,                                   // Offset.
                         __global int*       freedom,                                  // Freedom flag.
-                        __global float*     dt_simulation)                            // Simulation time step [s].
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global int*       morton,                                   // Morton codes (sorted).
+                        __global int*       sorted,                                   // Node indices (sorted by Morton code).
+                        __global int*       tree_child,                               // Tree children.
+                        __global int*       tree_parent,                              // Tree parents.
+                        __global float4*    tree_mass,                                // Tree centers of mass [m] and masses [kg].
+                        __global float4*    tree_box,                                 // Tree bounding boxes [m].
+                        __global int*       tree_flag,                                // Tree visit counters.
+                        __global float4*    field,                                    // Mutual gravitational force [N].
+                        __global float*     gravitation,                              // Gravitation parameters.
+                        __global int*       sort_pass,                                // Sorting pass parameters.
+                        __global float4*    position_lo,                              // Position (compensation) [m].
+                        __global int*       bucket_node,                              // Nodes (sorted by degree).
+                        __global int*       bucket)                                   // Bucket parameters.
 {
   //////////////////////////////////////////////////////////////////////////////////////
   ///////////////////////////////////// GLOBAL INDEX ///////////////////////////////////
@@ -29,6 +42,7 @@ __kernel void thekernel(__global float4*    color,
   float4        v                 = velocity[i];                                      // Central node velocity.
   float4        a                 = acceleration[i];                                  // Central node acceleration.
   float4        p_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);                 // Central node position. 
+  float4        dp                = (float4)(0.0f, 0.0f, 0.0f, 0.0f);                 // Central node position step.
   float         R0                = radius[0];                                        // Attractive nucleus radius.
   float         fr                = freedom[i];                                       // Central node freedom flag.
   float         dt                = dt_simulation[0];                                 // Simulation time step [s].
@@ -41,7 +55,9 @@ __kernel void thekernel(__global float4*    color,
   }
         
   // COMPUTING NEW POSITION:
-  p_new = p + v*dt + 0.5f*a*dt*dt;                                                    // Computing Taylor's approximation...
+  dp = v*dt + 0.5f*a*dt*dt;                                                           // Computing Taylor's approximation...
+  dp.w = 0.0f;                                                                        // Adjusting projective space...
+  p_new = advance_position(p, dp, position_lo, i);                                    // Advancing position ("precision_*.cl")...
         
   // UPDATING INTERMEDIATE POSITION:
   position_int[i] = p_new;                                                            // Updating intermediate position...
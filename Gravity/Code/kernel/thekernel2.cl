@@ -1,4 +1,5 @@
 /// @file
+/// @details  Dispatched once per degree bucket (bucket table: see "include/buckets.hpp").
 
 __kernel void thekernel(__global float4*    color,                                    // Color [#].
                         __global float4*    position,                                 // Position [m].
@@ -15,12 +16,27 @@ __kernel void thekernel(__global float4*    color,
                         __global int*       nearest,                                  // Neighbour.
                         __global int*       offset,                                   // Offset.
                         __global int*       freedom,                                  // Freedom flag.
-                        __global float*     dt_simulation)                            // Simulation time step [s].
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global int*       morton,                                   // Morton codes (sorted).
+                        __global int*       sorted,                                   // Node indices (sorted by Morton code).
+                        __global int*       tree_child,                               // Tree children.
+                        __global int*       tree_parent,                              // Tree parents.
+                        __global float4*    tree_mass,                                // Tree centers of mass [m] and masses [kg].
+                        __global float4*    tree_box,                                 // Tree bounding boxes [m].
+                        __global int*       tree_flag,                                // Tree visit counters.
+                        __global float4*    field,                                    // Mutual gravitational force [N].
+                        __global float*     gravitation,                              // Gravitation parameters.
+                        __global int*       sort_pass,                                // Sorting pass parameters.
+                        __global float4*    position_lo,                              // Position (compensation) [m].
+                        __global int*       bucket_node,                              // Nodes (sorted by degree).
+                        __global int*       bucket)                                   // Bucket parameters.
 {
   ////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// INDEXES ///////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
-  unsigned int i = get_global_id(0);                                            // Global index [#].
+  unsigned int q = get_global_id(0);                                            // Global index [#].
+  int          b = bucket[0];                                                   // Bucket table entry (negative = node order).
+  unsigned int i = (b < 0) ? q : bucket_node[bucket[3 + b] + q];                // Node index (degree bucket order) [#].
   unsigned int j = 0;                                                           // Neighbour stride index.
   unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
   unsigned int j_max = offset[i];                                               // Neighbour stride maximum index.
@@ -48,6 +64,8 @@ __kernel void thekernel(__global float4*    color,
   float4        Fv                = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node viscous force.
   float4        Fv_est            = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node viscous force (estimation).
   float4        Fg                = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node gravitational force. 
+  float4        Fm                = field[n];                                   // Central node mutual gravitational force.
+  float         mode              = gravitation[3];                             // Mutual gravitation mode.
   float4        F                 = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node total force.
   float4        F_new             = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Central node total force (new).
   float4        neighbour         = (float4)(0.0f, 0.0f, 0.0f, 1.0f);           // Neighbour node position.
@@ -98,6 +116,12 @@ __kernel void thekernel(__global float4*    color,
   }
   
   Fg = (float4)(-(m/pown(length(p_int.xyz), 2))*normalize(p_int.xyz), 1.0f);    // Computing gravitational force [N]...
+
+  if (mode != 0.0f)
+  {
+    Fg.xyz += Fm.xyz;                                                           // Adding mutual gravitational force [N]...
+  }
+
   Fv = -B*v_int;                                                                // Computing node viscous force...
 
   // COMPUTING TOTAL FORCE:
@@ -142,4 +166,11 @@ __kernel void thekernel(__global float4*    color,
   position[n] = p_int;                                                          // Updating position [m]...
   velocity[n] = v_new;                                                          // Updating velocity [m/s]...
   acceleration[n] = a_new;                                                      // Updating acceleration [m/s^2]...
+
+  // MOVING TO THE NEXT BUCKET (last work-item of the dispatch):
+  if ((b >= 0) && (atomic_inc(&bucket[1]) == (int)(get_global_size(0) - 1)))
+  {
+    bucket[1] = 0;                                                              // Resetting finished work-items...
+    bucket[0] = (b + 1) % bucket[2];                                            // Moving to next entry (wrapping to the first)...
+  }
 }
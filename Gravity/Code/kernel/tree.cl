@@ -0,0 +1,46 @@
+/// @file     tree.cl
+/// @brief    Linear tree utilities.
+/// @details  Morton codes and common prefix length of sorted Morton codes (Karras, 2012).
+
+// Spreading the 10 lower bits of "v" every 3 bits:
+uint expand_bits (uint v)
+{
+  v = (v*0x00010001u) & 0xFF0000FFu;
+  v = (v*0x00000101u) & 0x0F00F00Fu;
+  v = (v*0x00000011u) & 0xC30C30C3u;
+  v = (v*0x00000005u) & 0x49249249u;
+
+  return v;
+}
+
+// 30-bit Morton code of a point in the unit cube:
+uint morton_code (float3 p)
+{
+  uint x = (uint)clamp(p.x*1024.0f, 0.0f, 1023.0f);                             // Quantizing "x"...
+  uint y = (uint)clamp(p.y*1024.0f, 0.0f, 1023.0f);                             // Quantizing "y"...
+  uint z = (uint)clamp(p.z*1024.0f, 0.0f, 1023.0f);                             // Quantizing "z"...
+
+  return (expand_bits(x) << 2) | (expand_bits(y) << 1) | expand_bits(z);        // Interleaving bits...
+}
+
+// Common prefix length of sorted codes "i" and "j" (ties broken by index):
+int delta (__global int* morton, int n, int i, int j)
+{
+  uint a;                                                                       // Code "i".
+  uint b;                                                                       // Code "j".
+
+  if ((j < 0) || (j > (n - 1)))
+  {
+    return -1;                                                                  // Out of range...
+  }
+
+  a = (uint)morton[i];                                                          // Getting code "i"...
+  b = (uint)morton[j];                                                          // Getting code "j"...
+
+  if (a == b)
+  {
+    return 32 + clz((uint)(i ^ j));                                             // Breaking tie by index...
+  }
+
+  return clz(a ^ b);                                                            // Computing prefix length...
+}
@@ -0,0 +1,107 @@
+/// @file
+/// @brief    Barnes-Hut: radix tree topology (one work-item per internal node).
+
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position,                                 // Position [m].
+                        __global float4*    velocity,                                 // Velocity [m/s].
+                        __global float4*    acceleration,                             // Acceleration [m/s^2].
+                        __global float4*    position_int,                             // Position (intermediate) [m].
+                        __global float4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       central,                                  // Node.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global int*       morton,                                   // Morton codes (sorted).
+                        __global int*       sorted,                                   // Node indices (sorted by Morton code).
+                        __global int*       tree_child,                               // Tree children.
+                        __global int*       tree_parent,                              // Tree parents.
+                        __global float4*    tree_mass,                                // Tree centers of mass [m] and masses [kg].
+                        __global float4*    tree_box,                                 // Tree bounding boxes [m].
+                        __global int*       tree_flag,                                // Tree visit counters.
+                        __global float4*    field,                                    // Mutual gravitational force [N].
+                        __global float*     gravitation,                              // Gravitation parameters.
+                        __global int*       sort_pass,                                // Sorting pass parameters.
+                        __global float4*    position_lo,                              // Position (compensation) [m].
+                        __global int*       bucket_node,                              // Nodes (sorted by degree).
+                        __global int*       bucket)                                   // Bucket parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  int          i = get_global_id(0);                                            // Internal node index [#].
+  int          n = sort_pass[2];                                                // Number of leaves [#].
+  int          d;                                                               // Direction.
+  int          d_min;                                                           // Minimum prefix length.
+  int          d_node;                                                          // Node prefix length.
+  int          l_max;                                                           // Range length upper bound.
+  int          l;                                                               // Range length.
+  int          t;                                                               // Search step.
+  int          s;                                                               // Split offset.
+  int          j;                                                               // Range other end.
+  int          gamma;                                                           // Split position.
+  int          left;                                                            // Left child (unified index).
+  int          right;                                                           // Right child (unified index).
+
+  // DETERMINING RANGE DIRECTION:
+  d = ((delta(morton, n, i, i + 1) - delta(morton, n, i, i - 1)) >= 0) ? 1 : -1;
+  d_min = delta(morton, n, i, i - d);
+
+  // FINDING RANGE UPPER BOUND:
+  l_max = 2;
+
+  while (delta(morton, n, i, i + l_max*d) > d_min)
+  {
+    l_max *= 2;
+  }
+
+  // FINDING RANGE OTHER END (binary search):
+  l = 0;
+
+  for (t = l_max/2; t >= 1; t /= 2)
+  {
+    if (delta(morton, n, i, i + (l + t)*d) > d_min)
+    {
+      l += t;
+    }
+  }
+
+  j = i + l*d;
+  d_node = delta(morton, n, i, j);
+
+  // FINDING SPLIT POSITION (binary search):
+  s = 0;
+  t = l;
+
+  do
+  {
+    t = (t + 1)/2;
+
+    if (delta(morton, n, i, i + (s + t)*d) > d_node)
+    {
+      s += t;
+    }
+  }
+  while (t > 1);
+
+  gamma = i + s*d + min(d, 0);
+
+  // SETTING CHILDREN (internal nodes: 0...n-2, leaves: n-1...2n-2):
+  left = (min(i, j) == gamma) ? (n - 1 + gamma) : gamma;                        // Setting left child...
+  right = (max(i, j) == (gamma + 1)) ? (n - 1 + gamma + 1) : (gamma + 1);       // Setting right child...
+  tree_child[2*i + 0] = left;                                                   // Storing left child...
+  tree_child[2*i + 1] = right;                                                  // Storing right child...
+  tree_parent[left] = i;                                                        // Storing parent...
+  tree_parent[right] = i;                                                       // Storing parent...
+  tree_flag[i] = 0;                                                             // Resetting visit counter...
+
+  if (i == 0)
+  {
+    tree_parent[0] = -1;                                                        // Marking root...
+  }
+}
@@ -0,0 +1,86 @@
+/// @file
+/// @brief    Barnes-Hut: bottom-up masses, centers of mass and boxes (one work-item per leaf).
+
+__kernel void thekernel(__global float4*    color,                                    // Color [#].
+                        __global float4*    position,                                 // Position [m].
+                        __global float4*    velocity,                                 // Velocity [m/s].
+                        __global float4*    acceleration,                             // Acceleration [m/s^2].
+                        __global float4*    position_int,                             // Position (intermediate) [m].
+                        __global float4*    velocity_int,                             // Velocity (intermediate) [m/s].
+                        __global float*     radius,                                   // Particle radius [m].
+                        __global float*     stiffness,                                // Stiffness
+                        __global float*     resting,                                  // Resting distance [m].
+                        __global float*     friction,                                 // Friction
+                        __global float*     mass,                                     // Mass [kg].
+                        __global int*       central,                                  // Node.
+                        __global int*       nearest,                                  // Neighbour.
+                        __global int*       offset,                                   // Offset.
+                        __global int*       freedom,                                  // Freedom flag.
+                        __global float*     dt_simulation,                            // Simulation time step [s].
+                        __global int*       morton,                                   // Morton codes (sorted).
+                        __global int*       sorted,                                   // Node indices (sorted by Morton code).
+                        __global int*       tree_child,                               // Tree children.
+                        __global int*       tree_parent,                              // Tree parents.
+                        __global float4*    tree_mass,                                // Tree centers of mass [m] and masses [kg].
+                        __global float4*    tree_box,                                 // Tree bounding boxes [m].
+                        __global int*       tree_flag,                                // Tree visit counters.
+                        __global float4*    field,                                    // Mutual gravitational force [N].
+                        __global float*     gravitation,                              // Gravitation parameters.
+                        __global int*       sort_pass,                                // Sorting pass parameters.
+                        __global float4*    position_lo,                              // Position (compensation) [m].
+                        __global int*       bucket_node,                              // Nodes (sorted by degree).
+                        __global int*       bucket)                                   // Bucket parameters.
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////// INDEXES ///////////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  int          k = get_global_id(0);                                            // Leaf index (sorted order) [#].
+  int          n = sort_pass[2];                                                // Number of leaves [#].
+  int          u = n - 1 + k;                                                   // Tree node (unified index).
+  int          p;                                                               // Parent (internal index).
+  int          a;                                                               // Left child (unified index).
+  int          b;                                                               // Right child (unified index).
+  int          node = sorted[k];                                                // Mesh node index.
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ////////////////////////////////// CELL VARIABLES //////////////////////////////
+  ////////////////////////////////////////////////////////////////////////////////
+  float4        A;                                                              // Left child mass.
+  float4        B;                                                              // Right child mass.
+  float4        M;                                                              // Node mass.
+  volatile __global float4* vmass = tree_mass;                                  // Tree masses (not cached).
+  volatile __global float4* vbox  = tree_box;                                   // Tree boxes (not cached).
+
+  // SETTING LEAF:
+  M = (float4)(position_int[node].xyz, mass[node]);                             // Setting leaf center and mass...
+  vmass[u] = M;                                                                 // Storing leaf center and mass...
+  vbox[2*u + 0] = (float4)(M.xyz, 1.0f);                                        // Storing leaf box minimum...
+  vbox[2*u + 1] = (float4)(M.xyz, 1.0f);                                        // Storing leaf box maximum...
+
+  // CLIMBING TREE (the second work-item reaching a node summarizes it). The child data written
+  // by the first work-item, possibly of another work-group, is stored and loaded through volatile
+  // pointers around the fences, so that it goes to and comes from global memory, not a cache:
+  p = (n > 1) ? tree_parent[u] : -1;
+
+  while (p >= 0)
+  {
+    mem_fence(CLK_GLOBAL_MEM_FENCE);                                            // Publishing child data...
+
+    if (atomic_inc(&tree_flag[p]) == 0)
+    {
+      return;                                                                   // First visit: sibling not ready...
+    }
+
+    mem_fence(CLK_GLOBAL_MEM_FENCE);                                            // Ordering child data loads...
+    a = tree_child[2*p + 0];                                                    // Getting left child...
+    b = tree_child[2*p + 1];                                                    // Getting right child...
+    A = vmass[a];                                                               // Getting left child mass...
+    B = vmass[b];                                                               // Getting right child mass...
+    M.w = A.w + B.w;                                                            // Computing mass...
+    M.xyz = (A.w*A.xyz + B.w*B.xyz)/M.w;                                        // Computing center of mass...
+    vmass[p] = M;                                                               // Storing center and mass...
+    vbox[2*p + 0] = min(vbox[2*a + 0], vbox[2*b + 0]);                          // Storing box minimum...
+    vbox[2*p + 1] = max(vbox[2*a + 1], vbox[2*b + 1]);                          // Storing box maximum...
+    p = tree_parent[p];                                                         // Climbing...
+  }
+}
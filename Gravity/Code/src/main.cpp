@@ -12,6 +12,11 @@
 #define PANX          0.0f                                                                          // x-axis pan initial translation.
 #define PANY          0.0f                                                                          // y-axis pan initial translation.
 #define PANZ          -2.0f                                                                         // z-axis pan initial translation.
+#define GRAVITATION   0                                                                             // Mutual gravitation: 0 = off, 1 = Barnes-Hut, 2 = direct sum.
+#define THETA         0.5f                                                                          // Barnes-Hut opening angle.
+#define FIELD_RUNS    20                                                                            // Barnes-Hut/direct sum comparison length [runs].
+#define CHECK_STEPS   500                                                                           // Position precision comparison length [steps].
+#define SIMD_WIDTH    32                                                                            // SIMD width (degree bucket efficiency model) [#].
 
 #ifdef __linux__
   #define SHADER_HOME "../../Gravity/Code/shader/"                                                  // Linux OpenGL shaders directory.
@@ -31,12 +36,25 @@
 #define KERNEL_1      "thekernel1.cl"                                                               // OpenCL kernel source.
 #define KERNEL_2      "thekernel2.cl"                                                               // OpenCL kernel source.
 #define UTILITIES     "utilities.cl"                                                                // OpenCL kernel source.
+#define TREE          "tree.cl"                                                                     // OpenCL kernel source.
+#define KERNEL_MORTON "morton.cl"                                                                   // OpenCL kernel source.
+#define KERNEL_SORT   "bitonic.cl"                                                                  // OpenCL kernel source.
+#define KERNEL_BUILD  "tree_build.cl"                                                               // OpenCL kernel source.
+#define KERNEL_SUM    "tree_summarize.cl"                                                           // OpenCL kernel source.
+#define KERNEL_BH     "barnes_hut.cl"                                                               // OpenCL kernel source.
+#define KERNEL_DIRECT "direct_sum.cl"                                                               // OpenCL kernel source.
+#define PRECISION     "precision_compensated.cl"                                                    // OpenCL position update ("precision_float.cl", "precision_double.cl").
+#define REFERENCE     "precision_float.cl"                                                          // OpenCL position update (single precision reference).
 #define MESH          "gravity.msh"                                                                 // GMSH mesh.
 
 // INCLUDES:
 #include "nu.hpp"                                                                                   // Neutrino header file.
+#include "buckets.hpp"                                                                              // Degree buckets.
+#include "config.hpp"                                                                               // Runtime configuration.
+#include <chrono>                                                                                   // Standard clocks.
+#include <cstring>                                                                                  // Standard C strings.
 
-int main ()
+int main (int argc, char** argv)
 {
   // INDEXES:
   size_t                           i;                                                               // Index [#].
@@ -72,6 +90,14 @@ int main ()
   nu::opencl*                      cl             = new nu::opencl (NU_GPU);                        // OpenCL context.
   nu::kernel*                      K1             = new nu::kernel ();                              // OpenCL kernel array.
   nu::kernel*                      K2             = new nu::kernel ();                              // OpenCL kernel array.
+  nu::kernel*                      K_morton       = new nu::kernel ();                              // OpenCL kernel array.
+  nu::kernel*                      K_sort         = new nu::kernel ();                              // OpenCL kernel array.
+  nu::kernel*                      K_build        = new nu::kernel ();                              // OpenCL kernel array.
+  nu::kernel*                      K_sum          = new nu::kernel ();                              // OpenCL kernel array.
+  nu::kernel*                      K_bh           = new nu::kernel ();                              // OpenCL kernel array.
+  nu::kernel*                      K_direct       = new nu::kernel ();                              // OpenCL kernel array.
+  nu::kernel*                      K1_ref         = new nu::kernel ();                              // OpenCL kernel array (single precision reference).
+  std::vector<nu::kernel*>         K2_bucket;                                                       // OpenCL kernel arrays (corrector, one per degree bucket).
   nu::float4*                      color          = new nu::float4 (0);                             // Color [].
   nu::float4*                      position       = new nu::float4 (1);                             // Position [m].
   nu::float4*                      velocity       = new nu::float4 (2);                             // Velocity [m/s].
@@ -88,21 +114,29 @@ int main ()
   nu::int1*                        offset         = new nu::int1 (13);                              // Offset.
   nu::int1*                        freedom        = new nu::int1 (14);                              // Freedom.
   nu::float1*                      dt             = new nu::float1 (15);                            // Time step [s].
+  nu::int1*                        morton         = new nu::int1 (16);                              // Morton codes (sorted).
+  nu::int1*                        sorted         = new nu::int1 (17);                              // Node indices (sorted by Morton code).
+  nu::int1*                        tree_child     = new nu::int1 (18);                              // Tree children.
+  nu::int1*                        tree_parent    = new nu::int1 (19);                              // Tree parents.
+  nu::float4*                      tree_mass      = new nu::float4 (20);                            // Tree centers of mass [m] and masses [kg].
+  nu::float4*                      tree_box       = new nu::float4 (21);                            // Tree bounding boxes [m].
+  nu::int1*                        tree_flag      = new nu::int1 (22);                              // Tree visit counters.
+  nu::float4*                      field          = new nu::float4 (23);                            // Mutual gravitational force [N].
+  nu::float1*                      gravitation    = new nu::float1 (24);                            // Gravitation parameters.
+  nu::int1*                        sort_pass      = new nu::int1 (25);                              // Sorting pass parameters.
+  nu::float4*                      position_lo    = new nu::float4 (26);                            // Position (compensation) [m].
+  nu::int1*                        bucket_node    = new nu::int1 (27);                              // Nodes (sorted by degree).
+  nu::int1*                        bucket         = new nu::int1 (28);                              // Bucket parameters.
 
   // MESH:
-  nu::mesh*                        gravity        = new nu::mesh (
-                                                                  std::string (
-                                                                               GMSH_HOME
-                                                                              ) + std::string (
-                                                                                               MESH
-                                                                                              )
-                                                                 );                                 // Mesh cloth.
+  nu::mesh*                        gravity;                                                         // Mesh cloth.
   size_t                           nodes;                                                           // Number of nodes.
   size_t                           elements;                                                        // Number of elements.
   size_t                           groups;                                                          // Number of groups.
   size_t                           neighbours;                                                      // Number of neighbours.
   std::vector<GLint>               point;                                                           // Point on frame.
   size_t                           point_nodes;                                                     // Number of point nodes.
+  examples::buckets*               node_buckets;                                                    // Degree buckets.
   float                            x_min   = -1.0f;                                                 // "x_min" spatial boundary [m].
   float                            x_max   = +1.0f;                                                 // "x_max" spatial boundary [m].
   float                            y_min   = -1.0f;                                                 // "y_min" spatial boundary [m].
@@ -127,6 +161,38 @@ int main ()
   float                            R0      = 0.3f;                                                  // Nucleus radius [m].
   float                            dt_critical;                                                     // Critical time step [s].
   float                            dt_simulation;                                                   // Simulation time step [s].
+  float                            G;                                                               // Gravitational constant [m^3/(kg*s^2)].
+  float                            eps     = 0.1f;                                                  // Softening length [m].
+  float                            theta   = THETA;                                                 // Barnes-Hut opening angle.
+  float                            box_min = -2.0f;                                                 // Morton box minimum [m].
+  float                            box_size = 4.0f;                                                 // Morton box size [m].
+  size_t                           nodes_pow2;                                                      // Number of nodes (next power of 2) [#].
+  size_t                           k;                                                               // Bitonic sequence size [#].
+  size_t                           l;                                                               // Bitonic compare distance [#].
+
+  // MUTUAL GRAVITATION COMPARISON:
+  std::vector<nu_float4_structure> field_tree;                                                      // Barnes-Hut field.
+  std::vector<nu_float4_structure> field_direct;                                                    // Direct sum field.
+  double                           time_tree;                                                       // Barnes-Hut time [us].
+  double                           time_direct;                                                     // Direct sum time [us].
+  double                           error_num = 0.0;                                                 // Field error norm (squared).
+  double                           error_den = 0.0;                                                 // Field norm (squared).
+
+  // POSITION PRECISION COMPARISON:
+  std::vector<nu_float4_structure> position_ref;                                                    // Single precision position [m].
+  double                           time_ref;                                                        // Single precision time [us].
+  double                           time_mode;                                                       // Selected precision time [us].
+  double                           error_position = 0.0;                                            // Maximum position distance [m].
+
+  // DEGREE BUCKET COMPARISON:
+  double                           time_unsorted;                                                   // Corrector time (node order) [us].
+  double                           time_sorted;                                                     // Corrector time (degree buckets) [us].
+  std::vector<double>              time_bucket;                                                     // Corrector time (per bucket dispatch) [us].
+
+  // CONFIGURATION:
+  examples::config*                settings       = new examples::config ();                        // Runtime configuration.
+  std::vector<std::string>         overrides;                                                       // Parameter overrides ("--set").
+  std::string                      mesh_file;                                                       // GMSH mesh.
 
   // BACKUP:
   std::vector<nu_float4_structure> initial_position;                                                // Backing up initial data...
@@ -134,6 +200,57 @@ int main ()
   std::vector<nu_float4_structure> initial_velocity;                                                // Backing up initial data...
   std::vector<nu_float4_structure> initial_velocity_int;                                            // Backing up initial data...
   std::vector<nu_float4_structure> initial_acceleration;                                            // Backing up initial data...
+  std::vector<nu_float4_structure> initial_position_lo;                                             // Backing up initial data...
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////// COMMAND LINE //////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  // --config <file>:     the parameters are read from a "key = value" file.
+  // --set <key>=<value>: a parameter is overridden (after all the files, in command line order).
+  for(i = 1; i < (size_t)argc; i++)
+  {
+    if((strcmp (argv[i], "--config") == 0) || (strcmp (argv[i], "--set") == 0))
+    {
+      if((i + 1) == (size_t)argc)
+      {
+        std::cout << "Error: missing argument for " << argv[i] << std::endl;                        // Printing message...
+        exit (EXIT_FAILURE);                                                                        // Exiting...
+      }
+
+      if(strcmp (argv[i], "--config") == 0)
+      {
+        settings->load (argv[i + 1]);                                                               // Loading configuration...
+      }
+      else
+      {
+        overrides.push_back (argv[i + 1]);                                                          // Deferring override...
+      }
+
+      i++;                                                                                          // Skipping argument...
+    }
+    else
+    {
+      std::cout << "Error: unknown option " << argv[i] << std::endl;                                // Printing message...
+      exit (EXIT_FAILURE);                                                                          // Exiting...
+    }
+  }
+
+  // APPLYING OVERRIDES (after all the configuration files, whatever the command line order):
+  for(auto& o : overrides)
+  {
+    settings->set (o);                                                                              // Overriding parameter...
+  }
+
+  // SETTING CONFIGURATION (the defaults being the compile-time ones):
+  settings->check ({"mesh", "m", "K", "B", "R0", "eps", "theta"}, {});                              // Checking keys...
+  mesh_file = settings->get ("mesh", MESH);                                                         // Getting GMSH mesh...
+  m         = settings->get ("m", m);                                                               // Getting node mass [kg]...
+  K         = settings->get ("K", K);                                                               // Getting link elastic constant [kg/s^2]...
+  B         = settings->get ("B", B);                                                               // Getting damping [kg*s*m]...
+  R0        = settings->get ("R0", R0);                                                             // Getting nucleus radius [m]...
+  eps       = settings->get ("eps", eps);                                                           // Getting softening length [m]...
+  theta     = settings->get ("theta", theta);                                                       // Getting Barnes-Hut opening angle...
+  gravity   = new nu::mesh (std::string (GMSH_HOME) + mesh_file);                                   // Loading mesh...
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   ///////////////////////////////////////// DATA INITIALIZATION ///////////////////////////////////////
@@ -159,6 +276,17 @@ int main ()
   std::cout << "lenghts = " << gravity->neighbour_length.size () << std::endl;
   std::cout << "links = " << gravity->neighbour_link.size () << std::endl;
 
+  // SETTING DEGREE BUCKETS:
+  node_buckets      = new examples::buckets (offset->data);                                         // Bucketing nodes by degree...
+  bucket_node->data = node_buckets->node;                                                           // Setting nodes (sorted by degree)...
+  bucket->data      = node_buckets->table (false);                                                  // Setting bucket table (written once)...
+
+  for(i = 0; i < node_buckets->start.size (); i++)
+  {
+    std::cout << "bucket " << i << ": degree = " << node_buckets->degree[i] << ", nodes = "
+              << node_buckets->size[i] << std::endl;                                                // Printing message...
+  }
+
   dt_critical     = sqrt (m/K);                                                                     // Critical time step [s].
   dt_simulation   = 0.02f*dt_critical;                                                              // Simulation time step [s].
 
@@ -167,6 +295,44 @@ int main ()
   dt->data.push_back (dt_simulation);                                                               // Setting time step...
   radius->data.push_back (R0);                                                                      // Setting nucleus radius...
 
+  // SETTING NEUTRINO ARRAYS (mutual gravitation):
+  G               = 1.0f/(nodes*m);                                                                 // Normalizing total mass to the nucleus one...
+  gravitation->data.push_back (G);                                                                  // Setting gravitational constant...
+  gravitation->data.push_back (theta);                                                              // Setting opening angle...
+  gravitation->data.push_back (eps);                                                                // Setting softening length...
+  gravitation->data.push_back (GRAVITATION);                                                        // Setting mode...
+  gravitation->data.push_back (box_min);                                                            // Setting Morton box minimum...
+  gravitation->data.push_back (box_size);                                                           // Setting Morton box size...
+
+  nodes_pow2      = 2;                                                                              // Initializing padded size...
+
+  while(nodes_pow2 < nodes)
+  {
+    nodes_pow2 *= 2;                                                                                // Rounding up to power of 2...
+  }
+
+  sort_pass->data = {0, 0, (int)nodes, (int)nodes_pow2, 0};                                         // Setting sorting pass parameters...
+
+  for(k = 2; k <= nodes_pow2; k *= 2)
+  {
+    for(l = k/2; l > 0; l /= 2)
+    {
+      sort_pass->data.push_back ((int)k);                                                           // Setting bitonic sequence size...
+      sort_pass->data.push_back ((int)l);                                                           // Setting compare distance...
+      sort_pass->data[4]++;                                                                         // Counting sorting pass...
+    }
+  }
+
+  morton->data.assign (nodes_pow2, 0);                                                              // Setting Morton codes...
+  sorted->data.assign (nodes_pow2, 0);                                                              // Setting sorted indices...
+  tree_child->data.assign (2*(nodes - 1), 0);                                                       // Setting tree children...
+  tree_parent->data.assign (2*nodes - 1, 0);                                                        // Setting tree parents...
+  tree_mass->data.assign (2*nodes - 1, {0.0f, 0.0f, 0.0f, 0.0f});                                   // Setting tree masses...
+  tree_box->data.assign (2*(2*nodes - 1), {0.0f, 0.0f, 0.0f, 1.0f});                                // Setting tree boxes...
+  tree_flag->data.assign (nodes - 1, 0);                                                            // Setting tree visit counters...
+  field->data.assign (nodes, {0.0f, 0.0f, 0.0f, 1.0f});                                             // Setting mutual gravitational force...
+  position_lo->data.assign (nodes, {0.0f, 0.0f, 0.0f, 0.0f});                                       // Setting position compensation...
+
   // SETTING NEUTRINO ARRAYS ("nodes" depending):
   for(i = 0; i < nodes; i++)
   {
@@ -266,18 +432,56 @@ int main ()
   initial_velocity     = velocity->data;                                                            // Setting backup data...
   initial_velocity_int = velocity_int->data;                                                        // Setting backup data...
   initial_acceleration = acceleration->data;                                                        // Setting backup data...
+  initial_position_lo  = position_lo->data;                                                         // Setting backup data...
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENCL KERNELS INITIALIZATION /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
+  K1->addsource (std::string (KERNEL_HOME) + std::string (PRECISION));                              // Setting kernel source file...
   K1->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                              // Setting kernel source file...
   K1->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_1));                               // Setting kernel source file...
   K1->build (nodes, 0, 0);                                                                          // Building kernel program...
 
+  if(strcmp (PRECISION, REFERENCE) != 0)
+  {
+    K1_ref->addsource (std::string (KERNEL_HOME) + std::string (REFERENCE));                        // Setting kernel source file...
+    K1_ref->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                        // Setting kernel source file...
+    K1_ref->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_1));                         // Setting kernel source file...
+    K1_ref->build (nodes, 0, 0);                                                                    // Building kernel program...
+  }
+
   K2->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                              // Setting kernel source file...
   K2->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                               // Setting kernel source file...
   K2->build (nodes, 0, 0);                                                                          // Building kernel program...
 
+  for(i = 0; i < node_buckets->start.size (); i++)
+  {
+    K2_bucket.push_back (new nu::kernel ());                                                        // Adding bucket kernel...
+    K2_bucket[i]->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                  // Setting kernel source file...
+    K2_bucket[i]->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_2));                   // Setting kernel source file...
+    K2_bucket[i]->build (node_buckets->size[i], 0, 0);                                              // Building kernel program...
+  }
+
+  K_morton->addsource (std::string (KERNEL_HOME) + std::string (TREE));                             // Setting kernel source file...
+  K_morton->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_MORTON));                    // Setting kernel source file...
+  K_morton->build (nodes_pow2, 0, 0);                                                               // Building kernel program...
+
+  K_sort->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_SORT));                        // Setting kernel source file...
+  K_sort->build (nodes_pow2, 0, 0);                                                                 // Building kernel program...
+
+  K_build->addsource (std::string (KERNEL_HOME) + std::string (TREE));                              // Setting kernel source file...
+  K_build->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_BUILD));                      // Setting kernel source file...
+  K_build->build (nodes - 1, 0, 0);                                                                 // Building kernel program...
+
+  K_sum->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_SUM));                          // Setting kernel source file...
+  K_sum->build (nodes, 0, 0);                                                                       // Building kernel program...
+
+  K_bh->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_BH));                            // Setting kernel source file...
+  K_bh->build (nodes, 0, 0);                                                                        // Building kernel program...
+
+  K_direct->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_DIRECT));                    // Setting kernel source file...
+  K_direct->build (nodes, 0, 0);                                                                    // Building kernel program...
+
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENGL SHADERS INITIALIZATION /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -291,6 +495,232 @@ int main ()
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   cl->write ();
 
+  // BARNES-HUT FIELD (Morton codes, bitonic sort, radix tree, summary, traversal):
+  auto tree_field = [&]()
+                    {
+                      cl->execute (K_morton, NU_WAIT);                                              // Computing Morton codes...
+
+                      for(int pass = 0; pass < sort_pass->data[4]; pass++)
+                      {
+                        cl->execute (K_sort, NU_WAIT);                                              // Sorting Morton codes (pass advanced on the device)...
+                      }
+
+                      cl->execute (K_build, NU_WAIT);                                               // Building tree topology...
+                      cl->execute (K_sum, NU_WAIT);                                                 // Summarizing tree...
+                      cl->execute (K_bh, NU_WAIT);                                                  // Traversing tree...
+                    };
+
+  // COMPARING BARNES-HUT WITH DIRECT SUM (each method warmed up first, so that its first launches
+  // are not timed, then run FIELD_RUNS times):
+  cl->acquire ();
+  tree_field ();                                                                                    // Warming up (Barnes-Hut)...
+
+  auto t0 = std::chrono::steady_clock::now ();                                                      // Barnes-Hut start.
+
+  for(i = 0; i < FIELD_RUNS; i++)
+  {
+    tree_field ();                                                                                  // Computing Barnes-Hut field...
+  }
+
+  auto t1 = std::chrono::steady_clock::now ();                                                      // Barnes-Hut end.
+  cl->read (23);                                                                                    // Reading field...
+  field_tree   = field->data;                                                                       // Storing Barnes-Hut field...
+  cl->execute (K_direct, NU_WAIT);                                                                  // Warming up (direct sum)...
+
+  auto t2 = std::chrono::steady_clock::now ();                                                      // Direct sum start.
+
+  for(i = 0; i < FIELD_RUNS; i++)
+  {
+    cl->execute (K_direct, NU_WAIT);                                                                // Computing direct sum field...
+  }
+
+  auto t3 = std::chrono::steady_clock::now ();                                                      // Direct sum end.
+  cl->read (23);                                                                                    // Reading field...
+  field_direct = field->data;                                                                       // Storing direct sum field...
+
+  cl->release ();
+
+  time_tree    = std::chrono::duration<double, std::micro>(t1 - t0).count ()/FIELD_RUNS;            // Computing Barnes-Hut time...
+  time_direct  = std::chrono::duration<double, std::micro>(t3 - t2).count ()/FIELD_RUNS;            // Computing direct sum time...
+
+  for(i = 0; i < nodes; i++)
+  {
+    error_num += pow (field_tree[i].x - field_direct[i].x, 2) +
+                 pow (field_tree[i].y - field_direct[i].y, 2) +
+                 pow (field_tree[i].z - field_direct[i].z, 2);                                      // Accumulating error norm...
+    error_den += pow (field_direct[i].x, 2) +
+                 pow (field_direct[i].y, 2) +
+                 pow (field_direct[i].z, 2);                                                        // Accumulating field norm...
+  }
+
+  std::cout << "Barnes-Hut: " << time_tree << " us, direct sum: " << time_direct << " us (mean of "
+            << FIELD_RUNS << " runs), "
+            << "relative RMS error = " << sqrt (error_num/error_den) << std::endl;                  // Printing message...
+
+  // CORRECTOR (one dispatch per degree bucket, or one over all nodes in their own order): the
+  // kernels move along the bucket table themselves, which is written only when the order changes.
+  auto corrector = [&](bool loc_sorted, std::vector<double>* loc_time = nullptr)
+                   {
+                     if(loc_sorted != (bucket->data[0] >= 0))
+                     {
+                       bucket->data = node_buckets->table (!loc_sorted);                            // Setting bucket table...
+                       cl->write (28);                                                              // Writing bucket table (order change)...
+                     }
+
+                     if(!loc_sorted)
+                     {
+                       cl->execute (K2, NU_WAIT);                                                   // Executing OpenCL kernel...
+                     }
+                     else
+                     {
+                       for(size_t b = 0; b < K2_bucket.size (); b++)
+                       {
+                         auto d0 = std::chrono::steady_clock::now ();                               // Dispatch start.
+                         cl->execute (K2_bucket[b], NU_WAIT);                                       // Executing OpenCL kernel...
+
+                         if(loc_time != nullptr)
+                         {
+                           (*loc_time)[b] += std::chrono::duration<double, std::micro>(
+                                               std::chrono::steady_clock::now () - d0).count ();    // Accumulating dispatch time...
+                         }
+                       }
+                     }
+                   };
+
+  // SIMULATION STEP (predictor, mutual gravitation, corrector):
+  auto simulation_step = [&](nu::kernel* loc_predictor)
+                         {
+                           cl->execute (loc_predictor, NU_WAIT);                                    // Executing OpenCL kernel...
+
+                           switch(GRAVITATION)
+                           {
+                             case 1:
+                               tree_field ();                                                       // Computing Barnes-Hut field...
+                               break;
+
+                             case 2:
+                               cl->execute (K_direct, NU_WAIT);                                     // Computing direct sum field...
+                               break;
+                           }
+
+                           corrector (true);                                                        // Executing OpenCL kernels (degree buckets)...
+                         };
+
+  // RESTORING INITIAL STATE:
+  auto restore = [&]()
+                 {
+                   position->data     = initial_position;                                           // Restoring backup...
+                   position_int->data = initial_position_int;                                       // Restoring backup...
+                   velocity->data     = initial_velocity;                                           // Restoring backup...
+                   velocity_int->data = initial_velocity_int;                                       // Restoring backup...
+                   acceleration->data = initial_acceleration;                                       // Restoring backup...
+                   position_lo->data  = initial_position_lo;                                        // Restoring backup...
+                   cl->write (1);                                                                   // Writing data...
+                   cl->write (2);                                                                   // Writing data...
+                   cl->write (3);                                                                   // Writing data...
+                   cl->write (4);                                                                   // Writing data...
+                   cl->write (5);                                                                   // Writing data...
+                   cl->write (26);                                                                  // Writing data...
+                 };
+
+  // COMPARING POSITION PRECISION WITH SINGLE PRECISION (same initial state, same number of steps,
+  // skipped when the selected update is the single precision one):
+  if(strcmp (PRECISION, REFERENCE) != 0)
+  {
+    cl->acquire ();
+
+    auto t4 = std::chrono::steady_clock::now ();                                                    // Single precision start.
+
+    for(i = 0; i < CHECK_STEPS; i++)
+    {
+      simulation_step (K1_ref);                                                                     // Advancing simulation (single precision)...
+    }
+
+    auto t5 = std::chrono::steady_clock::now ();                                                    // Single precision end.
+    cl->read (1);                                                                                   // Reading position...
+    cl->release ();
+    position_ref = position->data;                                                                  // Storing single precision position...
+    restore ();                                                                                     // Restoring initial state...
+    cl->acquire ();
+
+    auto t6 = std::chrono::steady_clock::now ();                                                    // Selected precision start.
+
+    for(i = 0; i < CHECK_STEPS; i++)
+    {
+      simulation_step (K1);                                                                         // Advancing simulation (selected precision)...
+    }
+
+    auto t7 = std::chrono::steady_clock::now ();                                                    // Selected precision end.
+    cl->read (1);                                                                                   // Reading position...
+    cl->read (26);                                                                                  // Reading position compensation...
+    cl->release ();
+
+    time_ref     = std::chrono::duration<double, std::micro>(t5 - t4).count ()/CHECK_STEPS;         // Computing single precision time...
+    time_mode    = std::chrono::duration<double, std::micro>(t7 - t6).count ()/CHECK_STEPS;         // Computing selected precision time...
+
+    for(i = 0; i < nodes; i++)
+    {
+      error_position = std::max (
+                                 error_position,
+                                 sqrt (
+                                       pow ((double)position->data[i].x + position_lo->data[i].x - position_ref[i].x, 2) +
+                                       pow ((double)position->data[i].y + position_lo->data[i].y - position_ref[i].y, 2) +
+                                       pow ((double)position->data[i].z + position_lo->data[i].z - position_ref[i].z, 2)
+                                      )
+                                );                                                                  // Computing position distance...
+    }
+
+    std::cout << "position precision (" << PRECISION << "): " << time_mode << " us/step, single precision: "
+              << time_ref << " us/step, max |x - x_float| = " << error_position << " m after "
+              << CHECK_STEPS << " steps" << std::endl;                                              // Printing message...
+    restore ();                                                                                     // Restoring initial state...
+  }
+
+  // COMPARING DEGREE BUCKETS WITH NODE ORDER (corrector only, each order warmed up first, so that
+  // its table write and first dispatches are not timed):
+  cl->acquire ();
+  corrector (false);                                                                                // Warming up (node order)...
+
+  auto t8 = std::chrono::steady_clock::now ();                                                      // Node order start.
+
+  for(i = 0; i < CHECK_STEPS; i++)
+  {
+    corrector (false);                                                                              // Executing OpenCL kernel (node order)...
+  }
+
+  auto t9 = std::chrono::steady_clock::now ();                                                      // Node order end.
+  corrector (true);                                                                                 // Warming up (degree buckets)...
+  time_bucket.assign (K2_bucket.size (), 0.0);                                                      // Resetting dispatch times...
+
+  auto t10 = std::chrono::steady_clock::now ();                                                     // Degree buckets start.
+
+  for(i = 0; i < CHECK_STEPS; i++)
+  {
+    corrector (true, &time_bucket);                                                                 // Executing OpenCL kernels (degree buckets)...
+  }
+
+  auto t11 = std::chrono::steady_clock::now ();                                                     // Degree buckets end.
+  cl->release ();
+
+  time_unsorted = std::chrono::duration<double, std::micro>(t9 - t8).count ()/CHECK_STEPS;          // Computing node order time...
+  time_sorted   = std::chrono::duration<double, std::micro>(t11 - t10).count ()/CHECK_STEPS;        // Computing degree buckets time...
+
+  std::cout << "corrector (measured over " << CHECK_STEPS << " runs): node order = " << time_unsorted
+            << " us, degree buckets = " << time_sorted << " us (" << K2_bucket.size ()
+            << " dispatches)" << std::endl;                                                         // Printing message...
+
+  for(i = 0; i < K2_bucket.size (); i++)
+  {
+    std::cout << "bucket " << i << " (degree = " << node_buckets->degree[i] << ", nodes = "
+              << node_buckets->size[i] << "): " << time_bucket[i]/CHECK_STEPS
+              << " us/dispatch (measured)" << std::endl;                                            // Printing message...
+  }
+
+  std::cout << "SIMD efficiency model (width = " << SIMD_WIDTH << ", not measured): node order = "
+            << node_buckets->unsorted (SIMD_WIDTH) << ", degree buckets = "
+            << node_buckets->sorted (SIMD_WIDTH) << std::endl;                                      // Printing message...
+  restore ();                                                                                       // Restoring initial state...
+
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////// APPLICATION LOOP ////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -298,8 +728,7 @@ int main ()
   {
     cl->get_tic ();                                                                                 // Getting "tic" [us]...
     cl->acquire ();
-    cl->execute (K1, NU_WAIT);                                                                      // Executing OpenCL kernel...
-    cl->execute (K2, NU_WAIT);                                                                      // Executing OpenCL kernel...
+    simulation_step (K1);                                                                           // Advancing simulation...
     cl->release ();
 
     gl->clear ();                                                                                   // Clearing gl...
@@ -317,16 +746,7 @@ int main ()
 
     if(gl->button_TRIANGLE)
     {
-      position->data     = initial_position;                                                        // Restoring backup...
-      position_int->data = initial_position_int;                                                    // Restoring backup...
-      velocity->data     = initial_velocity;                                                        // Restoring backup...
-      velocity_int->data = initial_velocity_int;                                                    // Restoring backup...
-      acceleration->data = initial_acceleration;                                                    // Restoring backup...
-      cl->write (1);                                                                                // Writing data...
-      cl->write (2);                                                                                // Writing data...
-      cl->write (3);                                                                                // Writing data...
-      cl->write (4);                                                                                // Writing data...
-      cl->write (5);                                                                                // Writing data...
+      restore ();                                                                                   // Restoring initial state...
     }
 
     cl->get_toc ();                                                                                 // Getting "toc" [us]...
@@ -349,8 +769,36 @@ int main ()
   delete offset;                                                                                    // Deleting offset...
   delete freedom;                                                                                   // Deleting freedom flag data...
   delete dt;                                                                                        // Deleting time step data...
+  delete morton;                                                                                    // Deleting Morton codes...
+  delete sorted;                                                                                    // Deleting sorted indices...
+  delete tree_child;                                                                                // Deleting tree children...
+  delete tree_parent;                                                                               // Deleting tree parents...
+  delete tree_mass;                                                                                 // Deleting tree masses...
+  delete tree_box;                                                                                  // Deleting tree boxes...
+  delete tree_flag;                                                                                 // Deleting tree visit counters...
+  delete field;                                                                                     // Deleting mutual gravitational force...
+  delete gravitation;                                                                               // Deleting gravitation parameters...
+  delete sort_pass;                                                                                 // Deleting sorting pass parameters...
+  delete position_lo;                                                                               // Deleting position compensation...
+  delete bucket_node;                                                                               // Deleting bucket nodes...
+  delete bucket;                                                                                    // Deleting bucket parameters...
   delete K1;                                                                                        // Deleting OpenCL kernel...
   delete K2;                                                                                        // Deleting OpenCL kernel...
+  delete K_morton;                                                                                  // Deleting OpenCL kernel...
+  delete K_sort;                                                                                    // Deleting OpenCL kernel...
+  delete K_build;                                                                                   // Deleting OpenCL kernel...
+  delete K_sum;                                                                                     // Deleting OpenCL kernel...
+  delete K_bh;                                                                                      // Deleting OpenCL kernel...
+  delete K_direct;                                                                                  // Deleting OpenCL kernel...
+  delete K1_ref;                                                                                    // Deleting OpenCL kernel...
+
+  for(i = 0; i < K2_bucket.size (); i++)
+  {
+    delete K2_bucket[i];                                                                            // Deleting OpenCL kernel...
+  }
+
+  delete node_buckets;                                                                              // Deleting degree buckets...
+  delete settings;                                                                                  // Deleting configuration...
 
   return 0;
 }
\ No newline at end of file
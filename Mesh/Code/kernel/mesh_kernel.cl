@@ -1,16 +1,21 @@
 /// @file
+/// @details  Dispatched once per degree bucket (bucket table: see "include/buckets.hpp").
 
 __kernel void thekernel(__global float4*    color,                              // Color [#].
                         __global float4*    position,                           // Position [m].
                         __global int*       central,                            // Node.
                         __global int*       neighbour,                          // Neighbour.
-                        __global int*       offset                              // Offset.
+                        __global int*       offset,                             // Offset.
+                        __global int*       bucket_node,                        // Nodes (sorted by degree).
+                        __global int*       bucket                              // Bucket parameters.
                         )
 {
   ////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// INDICES ///////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////
-  unsigned int i = get_global_id(0);                                            // Global index [#].
+  unsigned int q = get_global_id(0);                                            // Global index [#].
+  int          b = bucket[0];                                                   // Bucket table entry (negative = node order).
+  unsigned int i = (b < 0) ? q : bucket_node[bucket[3 + b] + q];                // Node index (degree bucket order) [#].
   unsigned int j = 0;                                                           // Neighbour stride index.
   unsigned int j_min = 0;                                                       // Neighbour stride minimun index.
   unsigned int j_max = offset[i];                                               // Neighbour stride maximum index.
@@ -44,4 +49,11 @@ __kernel void thekernel(__global float4*    color,
     L = length(link);                                                           // Computing neighbour link length...
     color[j].xyz = colormap(50.0f*L);                                           // Setting color...
   }
+
+  // MOVING TO THE NEXT BUCKET (last work-item of the dispatch):
+  if ((b >= 0) && (atomic_inc(&bucket[1]) == (int)(get_global_size(0) - 1)))
+  {
+    bucket[1] = 0;                                                              // Resetting finished work-items...
+    bucket[0] = (b + 1) % bucket[2];                                            // Moving to next entry (wrapping to the first)...
+  }
 }
@@ -13,15 +13,22 @@
 #define TAG           1                                                                             // Surface tag.
 #define DIM           2                                                                             // Surface dimension.
 #define CELL_VERTICES 3                                                                             // Number of vertices per elementary cell.
+#define LINK_PIXELS   1.0f                                                                          // Link LOD threshold (projected length) [px].
+#define CAMERA_EPS    1.0e-6f                                                                       // Camera change tolerance.
+#define IDLE_WAIT     0.05                                                                          // Idle event wait timeout [s].
+#define SIMD_WIDTH    32                                                                            // SIMD width (degree bucket efficiency model) [#].
+#define CHECK_RUNS    100                                                                           // Degree bucket comparison length [runs].
 
 #ifdef __linux__
   #define SHADER_HOME "../../Mesh/Code/shader/"                                                     // Linux OpenGL shaders directory.
+  #define LINK_HOME   "../../include/shader/"                                                       // Linux OpenGL link shaders directory (shared).
   #define KERNEL_HOME "../../Mesh/Code/kernel/"                                                     // Linux OpenCL kernels directory.
   #define GMSH_HOME   "../../Mesh/Code/mesh/"                                                       // Linux GMSH mesh directory.
 #endif
 
 #ifdef WIN32
   #define SHADER_HOME "..\\..\\Mesh\\Code\\shader\\"                                                // Windows OpenGL shaders directory.
+  #define LINK_HOME   "..\\..\\include\\shader\\"                                                   // Windows OpenGL link shaders directory (shared).
   #define KERNEL_HOME "..\\..\\Mesh\\Code\\kernel\\"                                                // Windows OpenCL kernels directory.
   #define GMSH_HOME   "..\\..\\Mesh\\Code\\mesh\\"                                                  // Linux GMSH mesh directory.
 #endif
@@ -29,12 +36,25 @@
 #define SHADER_VERT   "voxel_vertex.vert"                                                           // OpenGL vertex shader.
 #define SHADER_GEOM   "voxel_geometry.geom"                                                         // OpenGL geometry shader.
 #define SHADER_FRAG   "voxel_fragment.frag"                                                         // OpenGL fragment shader.
+#define SHADER_COMP   "link_transform.comp"                                                         // OpenGL link node transform shader.
+#define SHADER_CULL   "link_cull.comp"                                                              // OpenGL link culling shader.
+#define SHADER_LINK   "link_vertex.vert"                                                            // OpenGL link vertex shader.
 #define KERNEL        "mesh_kernel.cl"                                                              // OpenCL kernel source.
 #define UTILITIES     "utilities.cl"                                                                // OpenCL utilities source.
 #define MESH          "Utah_teapot.msh"                                                             // GMSH mesh.
 
+#define DRAW_COLOR    0                                                                             // Link color SSBO binding (Neutrino layout index).
+#define DRAW_POSITION 1                                                                             // Node position SSBO binding (Neutrino layout index).
+#define DRAW_CENTRAL  2                                                                             // Central node SSBO binding (Neutrino layout index).
+#define DRAW_NEAREST  3                                                                             // Neighbour node SSBO binding (Neutrino layout index).
+#define DRAW_CLIP     36                                                                            // Link renderer SSBO bindings (36...38, rendering).
+
 // INCLUDES:
 #include "nu.hpp"                                                                                   // Neutrino's header file.
+#include "link_renderer.hpp"                                                                        // Instanced link renderer.
+#include "tracker.hpp"                                                                              // Change tracker.
+#include "buckets.hpp"                                                                              // Degree buckets.
+#include <chrono>                                                                                   // Standard clocks.
 
 int main ()
 {
@@ -58,6 +78,9 @@ int main ()
   // OPENGL:
   nu::opengl* gl             = new nu::opengl (NAME, SX, SY, ORBX, ORBY, PANX, PANY, PANZ);         // OpenGL context.
   nu::shader* S              = new nu::shader ();                                                   // OpenGL shader program.
+  examples::link_renderer* links;                                                                   // Link renderer.
+  examples::tracker*       state = new examples::tracker ();                                        // Change tracker.
+  bool                     redraw;                                                                  // Redraw flag.
 
   // OPENCL:
   nu::opencl* cl             = new nu::opencl (NU_GPU);                                             // OpenCL context.
@@ -67,6 +90,9 @@ int main ()
   nu::int1*   central        = new nu::int1 (2);                                                    // Central nodes.
   nu::int1*   neighbour      = new nu::int1 (3);                                                    // Neighbour.
   nu::int1*   offset         = new nu::int1 (4);                                                    // Offset.
+  nu::int1*   bucket_node    = new nu::int1 (5);                                                    // Nodes (sorted by degree).
+  nu::int1*   bucket         = new nu::int1 (6);                                                    // Bucket parameters.
+  std::vector<nu::kernel*> K_bucket;                                                                // OpenCL kernel arrays (one per degree bucket).
 
   // MESH:
   nu::mesh*   obj            = new nu::mesh (std::string (GMSH_HOME) + std::string (MESH));         // Mesh obj.
@@ -74,6 +100,10 @@ int main ()
   size_t      elements;                                                                             // Number of elements.
   size_t      groups;                                                                               // Number of groups.
   size_t      neighbours;                                                                           // Number of neighbours.
+  examples::buckets*       node_buckets;                                                            // Degree buckets.
+  double      time_unsorted;                                                                        // Kernel time (node order) [us].
+  double      time_sorted;                                                                          // Kernel time (degree buckets) [us].
+  std::vector<double> time_bucket;                                                                  // Kernel time (per bucket dispatch) [us].
   float       x_min          = -1.0f;                                                               // "x_min" spatial boundary [m].
   float       x_max          = +1.0f;                                                               // "x_max" spatial boundary [m].
   float       y_min          = -1.0f;                                                               // "y_min" spatial boundary [m].
@@ -125,6 +155,11 @@ int main ()
     std::cout << std::endl;                                                                         // Printing message...
   }
 
+  // SETTING DEGREE BUCKETS:
+  node_buckets      = new examples::buckets (offset->data);                                         // Bucketing nodes by degree...
+  bucket_node->data = node_buckets->node;                                                           // Setting nodes (sorted by degree)...
+  bucket->data      = node_buckets->table (false);                                                  // Setting bucket table (written once)...
+
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENCL KERNELS INITIALIZATION /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -132,18 +167,110 @@ int main ()
   K->addsource (std::string (KERNEL_HOME) + std::string (KERNEL));                                  // Setting kernel source file...
   K->build (nodes, 0, 0);                                                                           // Building kernel program...
 
+  for(i = 0; i < node_buckets->start.size (); i++)
+  {
+    K_bucket.push_back (new nu::kernel ());                                                         // Adding bucket kernel...
+    K_bucket[i]->addsource (std::string (KERNEL_HOME) + std::string (UTILITIES));                   // Setting kernel source file...
+    K_bucket[i]->addsource (std::string (KERNEL_HOME) + std::string (KERNEL));                      // Setting kernel source file...
+    K_bucket[i]->build (node_buckets->size[i], 0, 0);                                               // Building kernel program...
+  }
+
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENGL SHADERS INITIALIZATION /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), NU_VERTEX);                  // Setting shader source file...
   S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), NU_GEOMETRY);                // Setting shader source file...
   S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), NU_FRAGMENT);                // Setting shader source file...
-  S->build (neighbours);                                                                            // Building shader program...
+  S->build (0);                                                                                     // Building shader program (no points: it only holds the camera)...
+  links = new examples::link_renderer (std::string (LINK_HOME) + std::string (SHADER_COMP),         // Building link renderer...
+                                        std::string (LINK_HOME) + std::string (SHADER_CULL),
+                                        std::string (LINK_HOME) + std::string (SHADER_LINK),
+                                        std::string (SHADER_HOME) + std::string (SHADER_FRAG),
+                                        examples::link_renderer::define ("COLOR_BINDING", DRAW_COLOR) +
+                                        examples::link_renderer::define ("POSITION_BINDING", DRAW_POSITION) +
+                                        examples::link_renderer::define ("CENTRAL_BINDING", DRAW_CENTRAL) +
+                                        examples::link_renderer::define ("NEAREST_BINDING", DRAW_NEAREST),
+                                        DRAW_CLIP, LINK_PIXELS);
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// SETTING OPENCL KERNEL ARGUMENTS /////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   cl->write ();                                                                                     // Writing OpenCL data...
+  state->touch (1);                                                                                 // Marking position as written...
+  state->touch (2);                                                                                 // Marking central nodes as written...
+  state->touch (3);                                                                                 // Marking neighbours as written...
+  state->touch (4);                                                                                 // Marking offsets as written...
+
+  // LINK COLORS (one dispatch per degree bucket, or one over all nodes in their own order): the
+  // kernels move along the bucket table themselves, which is written only when the order changes.
+  auto link_colors = [&](bool loc_sorted, std::vector<double>* loc_time = nullptr)
+                     {
+                       if(loc_sorted != (bucket->data[0] >= 0))
+                       {
+                         bucket->data = node_buckets->table (!loc_sorted);                          // Setting bucket table...
+                         cl->write (6);                                                             // Writing bucket table (order change)...
+                       }
+
+                       if(!loc_sorted)
+                       {
+                         cl->execute (K, NU_WAIT);                                                  // Executing OpenCL kernel...
+                       }
+                       else
+                       {
+                         for(size_t b = 0; b < K_bucket.size (); b++)
+                         {
+                           auto d0 = std::chrono::steady_clock::now ();                             // Dispatch start.
+                           cl->execute (K_bucket[b], NU_WAIT);                                      // Executing OpenCL kernel...
+
+                           if(loc_time != nullptr)
+                           {
+                             (*loc_time)[b] += std::chrono::duration<double, std::micro>(
+                                                 std::chrono::steady_clock::now () - d0).count ();  // Accumulating dispatch time...
+                           }
+                         }
+                       }
+                     };
+
+  // COMPARING DEGREE BUCKETS WITH NODE ORDER (each order warmed up first, so that its table write
+  // and first dispatches are not timed, then run CHECK_RUNS times):
+  cl->acquire ();                                                                                   // Acquiring OpenCL kernel...
+  link_colors (false);                                                                              // Warming up (node order)...
+  auto t0 = std::chrono::steady_clock::now ();                                                      // Node order start.
+
+  for(i = 0; i < CHECK_RUNS; i++)
+  {
+    link_colors (false);                                                                            // Computing link colors (node order)...
+  }
+
+  auto t1 = std::chrono::steady_clock::now ();                                                      // Node order end.
+  link_colors (true);                                                                               // Warming up (degree buckets)...
+  time_bucket.assign (K_bucket.size (), 0.0);                                                       // Resetting dispatch times...
+  auto t2 = std::chrono::steady_clock::now ();                                                      // Degree buckets start.
+
+  for(i = 0; i < CHECK_RUNS; i++)
+  {
+    link_colors (true, &time_bucket);                                                               // Computing link colors (degree buckets)...
+  }
+
+  auto t3 = std::chrono::steady_clock::now ();                                                      // Degree buckets end.
+  cl->release ();                                                                                   // Releasing OpenCL kernel...
+  time_unsorted = std::chrono::duration<double, std::micro>(t1 - t0).count ()/CHECK_RUNS;           // Computing node order time...
+  time_sorted   = std::chrono::duration<double, std::micro>(t3 - t2).count ()/CHECK_RUNS;           // Computing degree buckets time...
+
+  std::cout << "link colors (measured over " << CHECK_RUNS << " runs): node order = " << time_unsorted
+            << " us, degree buckets = " << time_sorted << " us (" << K_bucket.size ()
+            << " dispatches)" << std::endl;                                                         // Printing message...
+
+  for(i = 0; i < K_bucket.size (); i++)
+  {
+    std::cout << "bucket " << i << " (degree = " << node_buckets->degree[i] << ", nodes = "
+              << node_buckets->size[i] << "): " << time_bucket[i]/CHECK_RUNS
+              << " us/dispatch (measured)" << std::endl;                                            // Printing message...
+  }
+
+  std::cout << "SIMD efficiency model (width = " << SIMD_WIDTH << ", not measured): node order = "
+            << node_buckets->unsorted (SIMD_WIDTH) << ", degree buckets = "
+            << node_buckets->sorted (SIMD_WIDTH) << std::endl;                                      // Printing message...
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////// APPLICATION LOOP ////////////////////////////////////////
@@ -151,16 +278,35 @@ int main ()
   while(!gl->closed ())                                                                             // Opening window...
   {
     cl->get_tic ();                                                                                 // Getting "tic" [us]...
-    cl->acquire ();                                                                                 // Acquiring OpenCL kernel...
-    cl->execute (K, NU_WAIT);                                                                       // Executing OpenCL kernel...
-    cl->release ();                                                                                 // Releasing OpenCL kernel...
+
+    // COMPUTING LINK COLORS (only when the mesh has changed):
+    if(state->dirty ("mesh_kernel", {1, 2, 3, 4}))
+    {
+      cl->acquire ();                                                                               // Acquiring OpenCL kernel...
+      link_colors (true);                                                                           // Executing OpenCL kernels (degree buckets)...
+      cl->release ();                                                                               // Releasing OpenCL kernel...
+      state->touch (0);                                                                             // Marking color as written...
+    }
 
     gl->clear ();                                                                                   // Clearing gl...
     gl->poll_events ();                                                                             // Polling gl events...
     gl->mouse_navigation (ms_orbit_rate, ms_pan_rate, ms_decaytime);                                // Polling mouse...
     gl->gamepad_navigation (gmp_orbit_rate, gmp_pan_rate, gmp_decaytime, gmp_deadzone);             // Polling gamepad...
     gl->plot (S);                                                                                   // Plotting shared arguments...
-    gl->refresh ();                                                                                 // Refreshing gl...
+
+    // REDRAWING (only when the data or the camera have changed):
+    redraw  = state->dirty ("frame", {0, 1});                                                       // Checking data...
+    redraw |= state->changed ("camera", links->camera (), CAMERA_EPS);                              // Checking camera...
+
+    if(redraw)
+    {
+      links->plot (nodes, neighbours);                                                              // Plotting links...
+      gl->refresh ();                                                                               // Refreshing gl...
+    }
+    else
+    {
+      glfwWaitEventsTimeout (IDLE_WAIT);                                                            // Idling until next event...
+    }
 
     if(gl->button_CROSS)
     {
@@ -179,7 +325,18 @@ int main ()
   delete central;                                                                                   // Deleting centrals...
   delete neighbour;                                                                                 // Deleting neighbours...
   delete offset;                                                                                    // Deleting offset...
+  delete bucket_node;                                                                               // Deleting bucket nodes...
+  delete bucket;                                                                                    // Deleting bucket parameters...
   delete K;                                                                                         // Deleting OpenCL kernel...
 
+  for(i = 0; i < K_bucket.size (); i++)
+  {
+    delete K_bucket[i];                                                                             // Deleting OpenCL kernel...
+  }
+
+  delete node_buckets;                                                                              // Deleting degree buckets...
+  delete links;                                                                                     // Deleting link renderer...
+  delete state;                                                                                     // Deleting change tracker...
+
   return 0;
 }
@@ -5,6 +5,9 @@
 ///
 /// @details  The sinusoidal sheet is defined by:
 /// @f$ z = 0.1 \sin(10 x - 0.1 t) + 0.1 \cos(10 y - 0.1 t) @f$
+/// All nodes share the same time, hence it is a single scalar set by the host at every frame. The
+/// "x" and "y" coordinates are computed from the global index and the grid parameters, so that each
+/// node only writes its own position.
 
 /// @brief **OpenCL kernel function**
 /// @details It computes the 3D coordinates of a sinsoidal sheet defined by:
@@ -12,29 +15,30 @@
 __kernel void thekernel (
         __global float4*    voxel_color,                                                            ///< Voxel color coordinates.
         __global float4*    voxel_point,                                                            ///< Voxel point coordinates.
-        __global float*     time                                                                    ///< Time [s].
+        __global float*     time,                                                                   ///< Time [s].
+        __global float*     grid                                                                    ///< Grid parameters [x_min, y_min, dx, dy, nodes_x].
         )
 {
         //////////////////////////////////////////////////////////////////////////////////////////////
         //////////////////////////////////////////// INDEXES /////////////////////////////////////////
         //////////////////////////////////////////////////////////////////////////////////////////////
         unsigned int gid = get_global_id(0);                                                        // Global index "0".
+        unsigned int nodes_x = (unsigned int)grid[4];                                               // Number of nodes in "x" direction [#].
+        unsigned int i = gid%nodes_x;                                                               // "x" direction index.
+        unsigned int j = gid/nodes_x;                                                               // "y" direction index.
 
         //////////////////////////////////////////////////////////////////////////////////////////////
         ///////////////////////////////////////////// NODES //////////////////////////////////////////
         //////////////////////////////////////////////////////////////////////////////////////////////
         float4 P;                                                                                   // Voxel point coordinates.
-        float4 C;                                                                                   // Voxel color coordinates.
         float t;                                                                                    // Time [s].
 
-        C = voxel_color[gid];                                                                       // Getting voxel color...
-        P = voxel_point[gid];                                                                       // Getting voxel point...
-        t = time[gid];                                                                              // Getting simulation time...
+        t = time[0];                                                                                // Getting simulation time...
 
+        P.x = grid[0] + i*grid[2];                                                                  // Computing "x" point coordinate...
+        P.y = grid[1] + j*grid[3];                                                                  // Computing "y" point coordinate...
         P.z = 0.1f*sin(10.0f*P.x - 0.1f*t) + 0.1f*cos(10.0f*P.y - 0.1f*t);                          // Computing "z" point coordinate...
-        t += 0.1;                                                                                   // Incrementing simulation time...
+        P.w = 1.0f;                                                                                 // Setting projective space...
 
-        voxel_color[gid] = C;                                                                       // Setting voxel color...
         voxel_point[gid] = P;                                                                       // Setting voxel point...
-        time[gid] = t;                                                                              // Setting simulation time...
 }
@@ -0,0 +1,36 @@
+/// @file
+#version 460 core
+
+uniform mat4 V_mat;                                                             // View matrix.
+uniform mat4 P_mat;                                                             // Projection matrix.
+uniform float size_x;                                                           // Framebuffer size_x.
+uniform float size_y;                                                           // Framebuffer size_y.
+uniform float AR;                                                               // Framebuffer aspect ratio.
+
+layout(std430, binding = 2) buffer voxel_time
+{
+  float time_SSBO[];                                                            // Time SSBO [s].
+};
+
+layout(std430, binding = 3) buffer voxel_grid
+{
+  float grid_SSBO[];                                                            // Grid parameters SSBO [x_min, y_min, dx, dy, nodes_x].
+};
+
+out vec4 node;                                                                  // Voxel position.
+
+/// @function
+/// It evaluates the sinusoidal sheet z = 0.1*sin(10*x - 0.1*t) + 0.1*cos(10*y - 0.1*t) at the grid
+/// point of the vertex, with no OpenCL pass.
+void main(void)
+{
+  uint nodes_x = uint(grid_SSBO[4]);                                            // Number of nodes in "x" direction [#].
+  uint i = uint(gl_VertexID)%nodes_x;                                           // "x" direction index.
+  uint j = uint(gl_VertexID)/nodes_x;                                           // "y" direction index.
+  float t = time_SSBO[0];                                                       // Simulation time [s].
+
+  node.x = grid_SSBO[0] + i*grid_SSBO[2];                                       // Computing "x" point coordinate...
+  node.y = grid_SSBO[1] + j*grid_SSBO[3];                                       // Computing "y" point coordinate...
+  node.z = 0.1*sin(10.0*node.x - 0.1*t) + 0.1*cos(10.0*node.y - 0.1*t);         // Computing "z" point coordinate...
+  node.w = 1.0;                                                                 // Setting projective space...
+}
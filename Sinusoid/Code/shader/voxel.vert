@@ -7,8 +7,15 @@ uniform float size_x;
 uniform float size_y;                                                           // Framebuffer size_y.
 uniform float AR;                                                               // Framebuffer aspect ratio.
 
+layout(std430, binding = 1) buffer voxel_position
+{
+  vec4 position_SSBO[];                                                         // Voxel position SSBO.
+};
+
+out vec4 node;                                                                  // Voxel position.
+
 /// @function
 void main(void)
-{        
-  // Doing nothing!
-}
\ No newline at end of file
+{
+  node = position_SSBO[gl_VertexID];                                            // Getting voxel position...
+}
@@ -12,6 +12,9 @@
 #define PANX          0.0f                                                                          // x-axis pan initial translation.
 #define PANY          0.0f                                                                          // y-axis pan initial translation.
 #define PANZ          -2.0f                                                                         // z-axis pan initial translation.
+#define SIDE          100                                                                           // Number of nodes per grid side [#].
+#define BENCH_SIDE    3163                                                                          // Number of nodes per grid side, benchmark (~10^7 nodes) [#].
+#define BENCH_FRAMES  200                                                                           // Benchmark length [frames].
 
 #ifdef __linux__
   #define SHADER_HOME "../../Sinusoid/Code/shader/"                                                 // Linux OpenGL shaders directory.
@@ -25,13 +28,17 @@
 
 #define KERNEL_FILE   "sine_kernel.cl"                                                              // OpenCL kernel.
 #define SHADER_VERT   "voxel.vert"                                                                  // OpenGL vertex shader.
+#define SHADER_SURF   "surface.vert"                                                                // OpenGL vertex shader (procedural surface).
 #define SHADER_GEOM   "voxel.geom"                                                                  // OpenGL geometry shader.
 #define SHADER_FRAG   "voxel.frag"                                                                  // OpenGL fragment shader.
 
 // INCLUDES:
 #include "nu.hpp"                                                                                   // Neutrino header file.
+#include "storage.hpp"                                                                              // OpenGL storage buffer.
+#include <chrono>                                                                                   // Standard clocks.
+#include <cstring>                                                                                  // Standard C strings.
 
-int main ()
+int main (int argc, char** argv)
 {
   // INDICES:
   size_t      i              = 0;                                                                   // "x" direction index.
@@ -53,22 +60,64 @@ int main ()
   nu::shader* S              = new nu::shader ();                                                   // OpenGL shader program.
 
   // OPENCL:
-  nu::opencl* cl             = new nu::opencl (NU_GPU);                                             // OpenCL context.
+  nu::opencl* cl             = nullptr;                                                             // OpenCL context.
   nu::kernel* K              = new nu::kernel ();                                                   // OpenCL kernel array.
   nu::float4* color          = new nu::float4 (0);                                                  // Color [].
   nu::float4* position       = new nu::float4 (1);                                                  // Position [m].
-  nu::float1* t              = new nu::float1 (2);                                                  // Time step [s].
+  nu::float1* t              = new nu::float1 (2);                                                  // Time [s].
+  nu::float1* grid           = new nu::float1 (3);                                                  // Grid parameters [x_min, y_min, dx, dy, nodes_x].
+
+  // VERTEX SHADER SURFACE (no OpenCL):
+  examples::storage* draw_color = nullptr;                                                          // Color (rendering).
+  examples::storage* draw_time  = nullptr;                                                          // Time (rendering).
+  examples::storage* draw_grid  = nullptr;                                                          // Grid parameters (rendering).
 
   // SIMULATION:
   float       x_min          = -1.0f;                                                               // "x_min" spatial boundary [m].
   float       x_max          = +1.0f;                                                               // "x_max" spatial boundary [m].
   float       y_min          = -1.0f;                                                               // "y_min" spatial boundary [m].
   float       y_max          = +1.0f;                                                               // "y_max" spatial boundary [m].
-  size_t      nodes_x        = 100;                                                                 // Number of nodes in "X" direction [#].
-  size_t      nodes_y        = 100;                                                                 // Number of nodes in "Y" direction [#].
-  size_t      nodes          = nodes_x*nodes_y;                                                     // Total number of nodes [#].
-  float       dx             = (x_max - x_min)/(nodes_x - 1);                                       // x-axis mesh spatial size [m].
-  float       dy             = (y_max - y_min)/(nodes_y - 1);                                       // y-axis mesh spatial size [m].
+  size_t      nodes_x        = SIDE;                                                                // Number of nodes in "X" direction [#].
+  size_t      nodes_y        = SIDE;                                                                // Number of nodes in "Y" direction [#].
+  size_t      nodes;                                                                                // Total number of nodes [#].
+  float       dx;                                                                                   // x-axis mesh spatial size [m].
+  float       dy;                                                                                   // y-axis mesh spatial size [m].
+
+  // MODES:
+  bool        surface        = false;                                                               // "true" = evaluate the surface in the vertex shader.
+  bool        benchmark      = false;                                                               // "true" = run the benchmark.
+  size_t      frame          = 0;                                                                   // Frame [#].
+  double      frame_time     = 0.0;                                                                 // Frame time [us].
+  double      kernel_time    = 0.0;                                                                 // Kernel time [us].
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////// COMMAND LINE //////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  // --surface:   the surface is evaluated in the vertex shader (no OpenCL pass).
+  // --benchmark: ~10^7 nodes, timed over a fixed number of frames.
+  for(i = 1; i < (size_t)argc; i++)
+  {
+    if(strcmp (argv[i], "--surface") == 0)
+    {
+      surface = true;                                                                               // Selecting vertex shader surface...
+    }
+
+    if(strcmp (argv[i], "--benchmark") == 0)
+    {
+      benchmark = true;                                                                             // Requesting benchmark...
+      nodes_x   = BENCH_SIDE;                                                                       // Setting benchmark grid...
+      nodes_y   = BENCH_SIDE;                                                                       // Setting benchmark grid...
+    }
+  }
+
+  nodes = nodes_x*nodes_y;                                                                          // Computing total number of nodes...
+  dx    = (x_max - x_min)/(nodes_x - 1);                                                            // Computing x-axis mesh spatial size...
+  dy    = (y_max - y_min)/(nodes_y - 1);                                                            // Computing y-axis mesh spatial size...
+
+  if(!surface)
+  {
+    cl = new nu::opencl (NU_GPU);                                                                   // Creating OpenCL context...
+  }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ///////////////////////////////////////// DATA INITIALIZATION //////////////////////////////////////
@@ -77,14 +126,17 @@ int main ()
   {
     for(i = 0; i < nodes_x; i++)
     {
-      // Setting point coordinates:
-      position->data.push_back (
+      // Setting point coordinates (computed by the kernel, only allocated here):
+      if(!surface)
       {
-        x_min + i*dx,
-        y_min + j*dy,
-        0.0f,
-        1.0f}
-                               );                                                                   // Setting position...
+        position->data.push_back (
+        {
+          x_min + i*dx,
+          y_min + j*dy,
+          0.0f,
+          1.0f}
+                                 );                                                                 // Setting position...
+      }
 
       // Setting point colors:
       color->data.push_back (
@@ -95,22 +147,33 @@ int main ()
         1.0f
       }
                             );                                                                      // Setting "r" color coordinate...
-
-      // Setting time:
-      t->data.push_back (0.0f);                                                                     // Setting time...
     }
   }
 
+  t->data    = {0.0f};                                                                              // Setting time...
+  grid->data = {x_min, y_min, dx, dy, (float)nodes_x};                                              // Setting grid parameters...
+
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENCL KERNELS INITIALIZATION //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  K->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_FILE));                             // Setting kernel source file...
-  K->build (nodes, 0, 0);                                                                           // Building kernel program...
+  if(cl != nullptr)
+  {
+    K->addsource (std::string (KERNEL_HOME) + std::string (KERNEL_FILE));                           // Setting kernel source file...
+    K->build (nodes, 0, 0);                                                                         // Building kernel program...
+  }
 
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////// OPENGL SHADERS INITIALIZATION //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), NU_VERTEX);                  // Setting shader source file...
+  if(surface)
+  {
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_SURF), NU_VERTEX);                // Setting shader source file...
+  }
+  else
+  {
+    S->addsource (std::string (SHADER_HOME) + std::string (SHADER_VERT), NU_VERTEX);                // Setting shader source file...
+  }
+
   S->addsource (std::string (SHADER_HOME) + std::string (SHADER_GEOM), NU_GEOMETRY);                // Setting shader source file...
   S->addsource (std::string (SHADER_HOME) + std::string (SHADER_FRAG), NU_FRAGMENT);                // Setting shader source file...
   S->build (nodes);                                                                                 // Building shader program...
@@ -118,17 +181,45 @@ int main ()
   /////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////// SETTING OPENCL KERNEL ARGUMENTS //////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////////////////////////
-  cl->write ();                                                                                     // Writing OpenCL data...
+  if(cl != nullptr)
+  {
+    cl->write ();                                                                                   // Writing OpenCL data...
+  }
+  else
+  {
+    draw_color = new examples::storage (0);                                                         // Creating color storage...
+    draw_time  = new examples::storage (2);                                                         // Creating time storage...
+    draw_grid  = new examples::storage (3);                                                         // Creating grid storage...
+    draw_color->upload (color->data);                                                               // Uploading color...
+    draw_grid->upload (grid->data);                                                                 // Uploading grid parameters...
+  }
+
+  if(benchmark)
+  {
+    glfwSwapInterval (0);                                                                           // Disabling v-sync...
+  }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////// APPLICATION LOOP ////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   while(!gl->closed ())                                                                             // Opening gui...
   {
-    cl->get_tic ();                                                                                 // Getting "tic" [us]...
-    cl->acquire ();                                                                                 // Acquiring OpenCL kernel...
-    cl->execute (K, NU_WAIT);                                                                       // Executing OpenCL kernel...
-    cl->release ();                                                                                 // Releasing OpenCL kernel...
+    auto t0 = std::chrono::steady_clock::now ();                                                    // Frame start.
+
+    if(cl != nullptr)
+    {
+      cl->get_tic ();                                                                               // Getting "tic" [us]...
+      cl->write (2);                                                                                // Writing time...
+      cl->acquire ();                                                                               // Acquiring OpenCL kernel...
+      cl->execute (K, NU_WAIT);                                                                     // Executing OpenCL kernel...
+      cl->release ();                                                                               // Releasing OpenCL kernel...
+    }
+    else
+    {
+      draw_time->upload (t->data);                                                                  // Uploading time...
+    }
+
+    auto t1 = std::chrono::steady_clock::now ();                                                    // Kernel end.
 
     gl->clear ();                                                                                   // Clearing gl...
     gl->poll_events ();                                                                             // Polling gl events...
@@ -142,12 +233,43 @@ int main ()
       gl->close ();                                                                                 // Closing gl...
     }
 
-    cl->get_toc ();                                                                                 // Getting "toc" [us]...
+    if(cl != nullptr)
+    {
+      cl->get_toc ();                                                                               // Getting "toc" [us]...
+    }
+
+    t->data[0] += 0.1f;                                                                             // Incrementing simulation time...
+
+    // BENCHMARK (the first frame, including set-up costs, is not timed):
+    if(benchmark)
+    {
+      glFinish ();                                                                                  // Waiting for frame...
+      auto t2 = std::chrono::steady_clock::now ();                                                  // Frame end.
+
+      if(frame > 0)
+      {
+        kernel_time += std::chrono::duration<double, std::micro>(t1 - t0).count ();                 // Accumulating kernel time...
+        frame_time  += std::chrono::duration<double, std::micro>(t2 - t0).count ();                 // Accumulating frame time...
+      }
+
+      if(++frame == BENCH_FRAMES + 1)
+      {
+        std::cout << "benchmark: " << nodes << " nodes, "
+                  << (surface ? "vertex shader" : "OpenCL kernel") << " surface" << std::endl;      // Printing message...
+        std::cout << "surface update: " << kernel_time/BENCH_FRAMES << " us/frame, frame: "
+                  << frame_time/BENCH_FRAMES << " us/frame ("
+                  << nodes/(frame_time/BENCH_FRAMES) << " Mnodes/s)" << std::endl;                  // Printing message...
+        gl->close ();                                                                               // Closing gl...
+      }
+    }
   }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////// CLEANUP ////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////
+  delete draw_color;                                                                                // Deleting color storage...
+  delete draw_time;                                                                                 // Deleting time storage...
+  delete draw_grid;                                                                                 // Deleting grid storage...
   delete gl;                                                                                        // Deleting OpenGL gui ...
   delete cl;                                                                                        // Deleting OpenCL context...
   delete S;                                                                                         // Deleting OpenGL shader...
@@ -155,6 +277,7 @@ int main ()
   delete position;                                                                                  // Deleting OpenGL point...
   delete color;                                                                                     // Deleting OpenGL color...
   delete t;                                                                                         // Deleting time...
+  delete grid;                                                                                      // Deleting grid parameters...
 
   return 0;
 }
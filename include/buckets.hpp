@@ -0,0 +1,161 @@
+/// @file     buckets.hpp
+/// @brief    Degree buckets of a mesh.
+///
+/// @details  A work-item looping over the links of its node idles, in a SIMD group, behind the
+/// node having the most links in that group: on meshes where interior, face, edge and corner nodes
+/// have different numbers of links a part of the lanes is always wasted. Here the nodes are grouped
+/// by number of links (degree) at setup time: each bucket is then dispatched on its own, all the
+/// work-items of a dispatch having the same loop trip count. Inside a bucket the nodes keep their
+/// mesh order, preserving memory locality as much as possible.
+
+#ifndef buckets_hpp
+#define buckets_hpp
+
+// INCLUDES:
+  #include <vector>                                                                                 // Standard vector.
+  #include <algorithm>                                                                              // Standard algorithms.
+  #include <cstddef>                                                                                // Standard size types.
+
+namespace examples
+{
+  class buckets
+  {
+    private:
+      std::vector<size_t> links;                                                                    // Node degree.
+
+      // Fraction of useful loop iterations when the nodes in "loc_order" are dispatched in SIMD
+      // groups of "loc_width" lanes, each group running as many iterations as its longest node
+      // (the groups never straddle two dispatches, "loc_dispatch" = start of each dispatch):
+      double efficiency (
+                         const std::vector<int>& loc_order,                                         // Dispatch order.
+                         const std::vector<int>& loc_dispatch,                                      // Dispatch starts.
+                         size_t                  loc_width                                          // SIMD width [#].
+                        )
+      {
+        double useful = 0.0;                                                                        // Useful iterations [#].
+        double total  = 0.0;                                                                        // Executed iterations [#].
+        size_t d;                                                                                   // Dispatch index.
+        size_t g;                                                                                   // Group start.
+        size_t i;                                                                                   // Index.
+        size_t begin;                                                                               // Dispatch begin.
+        size_t end;                                                                                 // Dispatch end.
+        size_t longest;                                                                             // Longest node in group.
+
+        for(d = 0; d < loc_dispatch.size (); d++)
+        {
+          begin = loc_dispatch[d];                                                                  // Setting dispatch begin...
+          end   = (d + 1 < loc_dispatch.size ()) ? loc_dispatch[d + 1] : loc_order.size ();         // Setting dispatch end...
+
+          for(g = begin; g < end; g += loc_width)
+          {
+            longest = 0;                                                                            // Resetting longest node...
+
+            for(i = g; i < std::min (g + loc_width, end); i++)
+            {
+              useful += links[loc_order[i]];                                                        // Accumulating useful iterations...
+              longest = std::max (longest, links[loc_order[i]]);                                    // Updating longest node...
+            }
+
+            total += (double)loc_width*longest;                                                     // Accumulating executed iterations...
+          }
+        }
+
+        return (total > 0.0) ? useful/total : 1.0;
+      }
+
+    public:
+      std::vector<int>    node;                                                                     // Nodes (sorted by degree).
+      std::vector<int>    start;                                                                    // Bucket start (in "node").
+      std::vector<int>    size;                                                                     // Bucket size [#].
+      std::vector<int>    degree;                                                                   // Bucket degree [#].
+
+      /// @brief **Class constructor.**
+      /// @details It computes the buckets from the neighbour (CSR) offsets, one offset per node
+      /// pointing at the end of its links.
+      template<typename I>
+      buckets (
+               const std::vector<I>& loc_offset                                                     // Neighbour offsets.
+              )
+      {
+        size_t i;                                                                                   // Index.
+
+        links.resize (loc_offset.size ());                                                          // Resizing node degree...
+        node.resize (loc_offset.size ());                                                           // Resizing nodes...
+
+        for(i = 0; i < loc_offset.size (); i++)
+        {
+          links[i] = (size_t)(loc_offset[i] - ((i == 0) ? 0 : loc_offset[i - 1]));                  // Computing node degree...
+          node[i]  = (int)i;                                                                        // Initializing identity...
+        }
+
+        std::stable_sort (node.begin (), node.end (), [&](int a, int b)
+                          {
+                            return links[a] < links[b];
+                          });                                                                       // Sorting nodes by degree...
+
+        for(i = 0; i < node.size (); i++)
+        {
+          if((i == 0) || (links[node[i]] != links[node[i - 1]]))
+          {
+            start.push_back ((int)i);                                                               // Opening bucket...
+            size.push_back (0);                                                                     // Opening bucket...
+            degree.push_back ((int)links[node[i]]);                                                 // Setting bucket degree...
+          }
+
+          size.back ()++;                                                                           // Adding node to bucket...
+        }
+      }
+
+      /// @brief **SIMD efficiency (node order).**
+      /// @details It returns the modelled fraction of useful neighbour loop iterations when all
+      /// nodes are dispatched at once in their own order, in SIMD groups of "loc_width" lanes.
+      double unsorted (
+                       size_t loc_width                                                             // SIMD width [#].
+                      )
+      {
+        std::vector<int> order (node.size ());                                                      // Node order.
+        size_t           i;                                                                         // Index.
+
+        for(i = 0; i < order.size (); i++)
+        {
+          order[i] = (int)i;                                                                        // Setting identity...
+        }
+
+        return efficiency (order, {0}, loc_width);
+      }
+
+      /// @brief **SIMD efficiency (buckets).**
+      /// @details It returns the modelled fraction of useful neighbour loop iterations when each
+      /// bucket is dispatched on its own, in SIMD groups of "loc_width" lanes.
+      double sorted (
+                     size_t loc_width                                                               // SIMD width [#].
+                    )
+      {
+        return efficiency (node, start, loc_width);
+      }
+
+      /// @brief **Bucket table.**
+      /// @details It returns the bucket parameters of the kernels, written once at setup: {entry,
+      /// finished work-items, entries, then the start of each bucket}. The kernels read the current
+      /// entry and the last work-item of each dispatch moves it to the next one (wrapping to the
+      /// first), so that the host writes nothing between the dispatches; hence the buckets must be
+      /// dispatched in order. "loc_unsorted" sets the entry to -1: one dispatch over all nodes in
+      /// their own order, the entry not being moved.
+      std::vector<int> table (
+                              bool loc_unsorted                                                     // "true" = node order.
+                             )
+      {
+        std::vector<int> parameters = {loc_unsorted ? -1 : 0, 0, (int)start.size ()};               // Bucket table.
+        size_t           b;                                                                         // Bucket index.
+
+        for(b = 0; b < start.size (); b++)
+        {
+          parameters.push_back (start[b]);                                                          // Adding bucket start...
+        }
+
+        return parameters;
+      }
+  };
+}
+
+#endif
@@ -0,0 +1,240 @@
+/// @file     config.hpp
+/// @brief    Runtime configuration.
+///
+/// @details  The parameters of an example are read at start-up from a text file of "key = value"
+/// lines ("#" starts a comment) and from "key=value" overrides on the command line, the defaults
+/// being the compile-time ones. The files are loaded first (a later file replacing the keys of an
+/// earlier one), then the overrides are set, whatever their order on the command line. A parameter can also be swept: "key=v1,v2,..." makes it an axis of a
+/// grid, whose points (all combinations of the axes) are then set one after the other by "point",
+/// so that a whole sweep runs within one process. The keys are checked against the ones the example
+/// reads, so that a misspelled key is reported instead of silently leaving a default in place.
+
+#ifndef config_hpp
+#define config_hpp
+
+// INCLUDES:
+  #include <map>                                                                                    // Standard map.
+  #include <set>                                                                                    // Standard set.
+  #include <vector>                                                                                 // Standard vector.
+  #include <string>                                                                                 // Standard strings.
+  #include <fstream>                                                                                // Standard file streams.
+  #include <sstream>                                                                                // Standard string streams.
+  #include <iostream>                                                                               // Standard streams.
+
+namespace examples
+{
+  class config
+  {
+    private:
+      std::map<std::string, std::string>                            value;                          // Parameter values.
+      std::vector<std::pair<std::string, std::vector<std::string> > > axis;                         // Sweep axes.
+
+      // Trimming blanks:
+      static std::string trim (
+                               std::string loc_text                                                 // Text.
+                              )
+      {
+        size_t begin = loc_text.find_first_not_of (" \t\r");                                        // First character.
+        size_t end   = loc_text.find_last_not_of (" \t\r");                                         // Last character.
+
+        return (begin == std::string::npos) ? "" : loc_text.substr (begin, end - begin + 1);
+      }
+
+      // Splitting "key=value" (or "key = value"):
+      static bool split (
+                         std::string  loc_text,                                                     // Text.
+                         std::string& loc_key,                                                      // Key.
+                         std::string& loc_value                                                     // Value.
+                        )
+      {
+        size_t equal = loc_text.find ('=');                                                         // Separator.
+
+        if(equal == std::string::npos)
+        {
+          return false;
+        }
+
+        loc_key   = trim (loc_text.substr (0, equal));                                              // Getting key...
+        loc_value = trim (loc_text.substr (equal + 1));                                             // Getting value...
+
+        return !loc_key.empty ();
+      }
+
+    public:
+      /// @brief **Load.**
+      /// @details It reads the "key = value" lines of a configuration file.
+      void load (
+                 std::string loc_path                                                               // Configuration file.
+                )
+      {
+        std::ifstream file (loc_path);                                                              // Configuration file.
+        std::string   line;                                                                         // Line.
+        std::string   key;                                                                          // Key.
+        std::string   text;                                                                         // Value.
+
+        if(!file.is_open ())
+        {
+          std::cout << "Error: unable to open configuration " << loc_path << std::endl;             // Printing message...
+          exit (EXIT_FAILURE);                                                                      // Exiting...
+        }
+
+        while(std::getline (file, line))
+        {
+          line = line.substr (0, line.find ('#'));                                                  // Dropping comment...
+
+          if(split (line, key, text))
+          {
+            value[key] = text;                                                                      // Setting value...
+          }
+        }
+      }
+
+      /// @brief **Set.**
+      /// @details It overrides a parameter by a "key=value" assignment.
+      void set (
+                std::string loc_assignment                                                          // Assignment.
+               )
+      {
+        std::string key;                                                                            // Key.
+        std::string text;                                                                           // Value.
+
+        if(!split (loc_assignment, key, text))
+        {
+          std::cout << "Error: invalid assignment " << loc_assignment << std::endl;                 // Printing message...
+          exit (EXIT_FAILURE);                                                                      // Exiting...
+        }
+
+        value[key] = text;                                                                          // Setting value...
+      }
+
+      /// @brief **Sweep.**
+      /// @details It adds a sweep axis by a "key=v1,v2,..." assignment.
+      void sweep (
+                  std::string loc_assignment                                                        // Assignment.
+                 )
+      {
+        std::string              key;                                                               // Key.
+        std::string              text;                                                              // Values.
+        std::string              item;                                                              // Value.
+        std::vector<std::string> items;                                                             // Axis values.
+
+        if(!split (loc_assignment, key, text))
+        {
+          std::cout << "Error: invalid sweep " << loc_assignment << std::endl;                      // Printing message...
+          exit (EXIT_FAILURE);                                                                      // Exiting...
+        }
+
+        std::istringstream list (text);                                                             // Value list.
+
+        while(std::getline (list, item, ','))
+        {
+          items.push_back (trim (item));                                                            // Adding axis value...
+        }
+
+        axis.push_back ({key, items});                                                              // Adding axis...
+      }
+
+      /// @brief **Check.**
+      /// @details It exits on any key (set or swept) not in "loc_keys", and on any sweep axis not in
+      /// "loc_sweepable" (the parameters that can change between the points of a sweep).
+      void check (
+                  std::set<std::string> loc_keys,                                                   // Known keys.
+                  std::set<std::string> loc_sweepable                                               // Sweepable keys.
+                 )
+      {
+        for(auto& v : value)
+        {
+          if(loc_keys.count (v.first) == 0)
+          {
+            std::cout << "Error: unknown parameter " << v.first << std::endl;                       // Printing message...
+            exit (EXIT_FAILURE);                                                                    // Exiting...
+          }
+        }
+
+        for(auto& a : axis)
+        {
+          if(loc_keys.count (a.first) == 0)
+          {
+            std::cout << "Error: unknown parameter " << a.first << std::endl;                       // Printing message...
+            exit (EXIT_FAILURE);                                                                    // Exiting...
+          }
+
+          if(loc_sweepable.count (a.first) == 0)
+          {
+            std::cout << "Error: parameter " << a.first << " cannot be swept" << std::endl;         // Printing message...
+            exit (EXIT_FAILURE);                                                                    // Exiting...
+          }
+        }
+      }
+
+      /// @brief **Points.**
+      /// @details It returns the number of points of the sweep grid (0 if there is no sweep).
+      size_t points ()
+      {
+        size_t count = axis.empty () ? 0 : 1;                                                       // Number of points.
+
+        for(auto& a : axis)
+        {
+          count *= a.second.size ();                                                                // Multiplying axis size...
+        }
+
+        return count;
+      }
+
+      /// @brief **Point.**
+      /// @details It sets the parameters of the sweep grid point "loc_point" (the first axis
+      /// varying fastest) and returns them as a "key=value" list.
+      std::string point (
+                         size_t loc_point                                                           // Grid point.
+                        )
+      {
+        std::string label;                                                                          // Point label.
+
+        for(auto& a : axis)
+        {
+          value[a.first] = a.second[loc_point%a.second.size ()];                                    // Setting axis value...
+          loc_point     /= a.second.size ();                                                        // Moving to next axis...
+          label         += (label.empty () ? "" : " ") + a.first + "=" + value[a.first];            // Building label...
+        }
+
+        return label;
+      }
+
+      /// @brief **Get.**
+      /// @details It returns a parameter, or "loc_default" if it is not set. The whole value must be
+      /// read: trailing characters (e.g. "1e3x") are an error.
+      template<typename T>
+      T get (
+             std::string loc_key,                                                                   // Key.
+             T           loc_default                                                                // Default value.
+            )
+      {
+        T result = loc_default;                                                                     // Result.
+
+        if(value.count (loc_key) != 0)
+        {
+          std::istringstream text (value[loc_key]);                                                 // Value text.
+
+          if(!(text >> result) || !text.eof ())
+          {
+            std::cout << "Error: invalid value for " << loc_key << std::endl;                       // Printing message...
+            exit (EXIT_FAILURE);                                                                    // Exiting...
+          }
+        }
+
+        return result;
+      }
+
+      /// @brief **Get (text).**
+      /// @details It returns a text parameter, or "loc_default" if it is not set.
+      std::string get (
+                       std::string loc_key,                                                         // Key.
+                       const char* loc_default                                                      // Default value.
+                      )
+      {
+        return (value.count (loc_key) != 0) ? value[loc_key] : std::string (loc_default);
+      }
+  };
+}
+
+#endif
@@ -0,0 +1,390 @@
+/// @file     cpu_solver.hpp
+/// @brief    Multithreaded SIMD mass-spring solver (CPU reference).
+///
+/// @details  It advances the same predictor/corrector scheme of the Cloth OpenCL kernels
+/// ("thekernel_1.cl", "thekernel_2.cl") over the same host arrays (CSR neighbours included), so it
+/// can run the example when no OpenCL device is available and serve as an independent reference
+/// for the GPU results. The nodes are split in blocks executed by a work-stealing thread pool; within
+/// a block the integration runs over SIMD packs of nodes and the elastic forces over SIMD lanes of
+/// nodes walking their links together (see "simd.hpp"). Contacts are limited to the spherical obstacle: the
+/// self-collision grid of the GPU path is not replicated.
+
+#ifndef cpu_solver_hpp
+#define cpu_solver_hpp
+
+// INCLUDES:
+  #include "nu.hpp"                                                                                 // Neutrino's header file.
+  #include "thread_pool.hpp"                                                                        // Work-stealing thread pool.
+  #include "simd.hpp"                                                                               // Node-wise SIMD packs.
+  #include <vector>                                                                                 // Standard vector.
+  #include <cmath>                                                                                  // Standard math.
+
+namespace examples
+{
+  class cpu_solver
+  {
+    private:
+      thread_pool                       pool;                                                       // Thread pool.
+      size_t                            nodes;                                                      // Number of nodes [#].
+      size_t                            block;                                                      // Block size [#].
+      size_t                            blocks;                                                     // Number of blocks [#].
+      std::vector<int>&                 color;                                                      // Link color (RGBA8).
+      std::vector<nu_float4_structure>& position;                                                   // Position [m].
+      std::vector<nu_float4_structure>& velocity;                                                   // Velocity [m/s].
+      std::vector<nu_float4_structure>& acceleration;                                               // Acceleration [m/s^2].
+      std::vector<nu_float4_structure>& position_int;                                               // Position (intermediate) [m].
+      std::vector<nu_float4_structure>& velocity_int;                                               // Velocity (intermediate) [m/s].
+      std::vector<nu_float4_structure>& gravity;                                                    // Gravity [m/s^2].
+      std::vector<float>&               stiffness;                                                  // Link stiffness [kg/s^2].
+      std::vector<float>&               resting;                                                    // Link resting length [m].
+      std::vector<float>&               friction;                                                   // Friction [kg/s].
+      std::vector<float>&               mass;                                                       // Node mass [kg].
+      std::vector<int>&                 nearest;                                                    // Neighbour indices.
+      std::vector<int>&                 offset;                                                     // Neighbour offsets.
+      std::vector<int>&                 freedom;                                                    // Freedom flags.
+      std::vector<float>&               dt;                                                         // Time step [s].
+      std::vector<float>&               contact;                                                    // Contact parameters.
+      std::vector<nu_float4_structure>  force;                                                      // Elastic + contact force [N].
+
+      // Color channel byte (clamped to [0...1], then rounded):
+      static unsigned int channel (
+                                   float loc_value                                                  // Channel value.
+                                  )
+      {
+        return (unsigned int)std::lround (255.0f*std::min (std::max (loc_value, 0.0f), 1.0f));
+      }
+
+      // Turbo colormap (polynomial approximation of the table in "utilities.cl"), packed as RGBA8:
+      static int colormap (
+                           float        loc_intensity,                                              // Intensity [0...1].
+                           unsigned int loc_alpha                                                   // Alpha byte.
+                          )
+      {
+        float x  = std::min (std::max (loc_intensity, 0.0f), 1.0f);                                 // Clamped intensity.
+        float x2 = x*x;
+        float x3 = x2*x;
+        float x4 = x3*x;
+        float x5 = x4*x;
+        float r;                                                                                    // Red.
+        float g;                                                                                    // Green.
+        float b;                                                                                    // Blue.
+
+        r = 0.13572138f + 4.61539260f*x - 42.66032258f*x2 + 132.13108234f*x3 -
+            152.94239396f*x4 + 59.28637943f*x5;                                                     // Setting red...
+        g = 0.09140261f + 2.19418839f*x + 4.84296658f*x2 - 14.18503333f*x3 +
+            4.27729857f*x4 + 2.82956604f*x5;                                                        // Setting green...
+        b = 0.10667330f + 12.64194608f*x - 60.58204836f*x2 + 110.36276771f*x3 -
+            89.90310912f*x4 + 27.34824973f*x5;                                                      // Setting blue...
+
+        return (int)(channel (r) | (channel (g) << 8) | (channel (b) << 16) | (loc_alpha << 24));
+      }
+
+      // Freedom flags (0 or 1) of the pack of nodes starting at "loc_i", converted at each step so
+      // that the edits of the host flags (patches, reset) are seen right away:
+      template<class V>
+      typename V::type flags (
+                              size_t loc_i                                                          // First node.
+                             )
+      {
+        float  f[4];                                                                                // Freedom flags.
+        size_t k;                                                                                   // Pack node index.
+
+        for(k = 0; k < V::nodes; k++)
+        {
+          f[k] = (freedom[loc_i + k] == 0) ? 0.0f : 1.0f;                                           // Converting freedom flag...
+        }
+
+        return V::node (f);
+      }
+
+      // Predictor ("thekernel_1.cl") over packs of nodes in [loc_begin, loc_end):
+      template<class V>
+      size_t predict (
+                      size_t loc_begin,                                                             // First node.
+                      size_t loc_end                                                                // Last node + 1.
+                     )
+      {
+        typedef typename V::type P;
+        float  h  = dt[0];                                                                          // Time step [s].
+        P      H  = V::set1 (h);                                                                    // Time step [s].
+        P      H2 = V::set1 (0.5f*h*h);                                                             // Half squared time step [s^2].
+        P      fr;                                                                                  // Freedom flags.
+        P      p;                                                                                   // Position.
+        P      v;                                                                                   // Velocity.
+        P      a;                                                                                   // Acceleration.
+        size_t i;                                                                                   // Node index.
+
+        for(i = loc_begin; (i + V::nodes) <= loc_end; i += V::nodes)
+        {
+          fr = flags<V>(i);                                                                         // Getting freedom flags...
+          p  = V::load (&position[i].x);                                                            // Getting position...
+          v  = V::mul (V::load (&velocity[i].x), fr);                                               // Constraining velocity...
+          a  = V::mul (V::load (&acceleration[i].x), fr);                                           // Constraining acceleration...
+          V::store (&position_int[i].x, V::projective (V::add (p, V::add (V::mul (v, H), V::mul (a, H2)))));
+          V::store (&velocity_int[i].x, V::projective (V::add (v, V::mul (a, H))));
+        }
+
+        return i;
+      }
+
+      // Obstacle reaction on node "loc_i", added to its elastic force (stored):
+      void obstacle (
+                     size_t loc_i,                                                                  // Node index.
+                     float  loc_Fx,                                                                 // Elastic force "x" [N].
+                     float  loc_Fy,                                                                 // Elastic force "y" [N].
+                     float  loc_Fz                                                                  // Elastic force "z" [N].
+                    )
+      {
+        nu_float4_structure p  = position_int[loc_i];                                               // Node position [m].
+        float               r  = contact[1];                                                        // Contact radius [m].
+        float               Kc = contact[2];                                                        // Contact stiffness [kg/s^2].
+        float               RO = contact[6];                                                        // Obstacle radius [m].
+        float               dx = p.x - contact[3];                                                  // Obstacle separation "x" [m].
+        float               dy = p.y - contact[4];                                                  // Obstacle separation "y" [m].
+        float               dz = p.z - contact[5];                                                  // Obstacle separation "z" [m].
+        float               L  = std::sqrt (dx*dx + dy*dy + dz*dz);                                 // Obstacle distance [m].
+
+        if((L < (RO + r)) && (L > 0.0f))
+        {
+          loc_Fx += Kc*(RO + r - L)*dx/L;                                                           // Building up obstacle reaction...
+          loc_Fy += Kc*(RO + r - L)*dy/L;                                                           // Building up obstacle reaction...
+          loc_Fz += Kc*(RO + r - L)*dz/L;                                                           // Building up obstacle reaction...
+        }
+
+        force[loc_i] = {loc_Fx, loc_Fy, loc_Fz, 0.0f};                                              // Storing force...
+      }
+
+      // Elastic and contact forces over lanes of nodes in [loc_begin, loc_end) (link colors updated):
+      // the nodes of a pack walk their links together, a lane being masked off once its node has
+      // no links left.
+      template<class L>
+      size_t gather (
+                     size_t loc_begin,                                                              // First node.
+                     size_t loc_end                                                                 // Last node + 1.
+                    )
+      {
+        typedef typename L::type  P;
+        typedef typename L::index J;
+        typedef typename L::mask  M;
+        float  x[16];                                                                               // Node position "x" [m].
+        float  y[16];                                                                               // Node position "y" [m].
+        float  z[16];                                                                               // Node position "z" [m].
+        float  f[3][16];                                                                            // Elastic force [N].
+        float  s[16];                                                                               // Link strain [m].
+        int    j_min[16];                                                                           // Neighbour stride minimum index.
+        int    j_max[16];                                                                           // Neighbour stride maximum index.
+        int    k[16];                                                                               // Link index.
+        P      X;                                                                                   // Node position "x" [m].
+        P      Y;                                                                                   // Node position "y" [m].
+        P      Z;                                                                                   // Node position "z" [m].
+        P      Fx;                                                                                  // Force "x" [N].
+        P      Fy;                                                                                  // Force "y" [N].
+        P      Fz;                                                                                  // Force "z" [N].
+        P      dx;                                                                                  // Link "x" [m].
+        P      dy;                                                                                  // Link "y" [m].
+        P      dz;                                                                                  // Link "z" [m].
+        P      D;                                                                                   // Link length [m].
+        P      S;                                                                                   // Link strain [m].
+        P      W;                                                                                   // Link force over link length [N/m].
+        J      j;                                                                                   // Link index.
+        J      j_end;                                                                               // Neighbour stride maximum index.
+        J      n;                                                                                   // Neighbour index.
+        M      on;                                                                                  // Active lanes.
+        size_t i;                                                                                   // Node index.
+        size_t l;                                                                                   // Lane index.
+
+        for(i = loc_begin; (i + L::lanes) <= loc_end; i += L::lanes)
+        {
+          for(l = 0; l < L::lanes; l++)
+          {
+            x[l]     = position_int[i + l].x;                                                       // Getting node position...
+            y[l]     = position_int[i + l].y;                                                       // Getting node position...
+            z[l]     = position_int[i + l].z;                                                       // Getting node position...
+            j_min[l] = (i + l == 0) ? 0 : offset[i + l - 1];                                        // Getting neighbour stride...
+            j_max[l] = offset[i + l];                                                               // Getting neighbour stride...
+          }
+
+          X     = L::load (x);                                                                      // Loading node position...
+          Y     = L::load (y);                                                                      // Loading node position...
+          Z     = L::load (z);                                                                      // Loading node position...
+          Fx    = L::set1 (0.0f);                                                                   // Resetting force...
+          Fy    = L::set1 (0.0f);                                                                   // Resetting force...
+          Fz    = L::set1 (0.0f);                                                                   // Resetting force...
+          j     = L::load_index (j_min);                                                            // Getting first links...
+          j_end = L::load_index (j_max);                                                            // Getting stride ends...
+          on    = L::less (j, j_end);                                                               // Masking nodes without links...
+
+          while(L::any (on))
+          {
+            n  = L::gather_index (&nearest[0], j, on);                                              // Getting neighbours...
+            dx = L::sub (L::gather_node (&position_int[0].x, n, on), X);                            // Computing link...
+            dy = L::sub (L::gather_node (&position_int[0].y, n, on), Y);                            // Computing link...
+            dz = L::sub (L::gather_node (&position_int[0].z, n, on), Z);                            // Computing link...
+            D  = L::sqrt (L::add (L::mul (dx, dx), L::add (L::mul (dy, dy), L::mul (dz, dz))));     // Computing link length...
+            S  = L::sub (D, L::gather (&resting[0], j, on));                                        // Computing link strain...
+            W  = L::mul (L::mul (L::gather (&stiffness[0], j, on), S), L::inverse (D));             // Computing link force (masked lanes: 0)...
+            Fx = L::add (Fx, L::mul (W, dx));                                                       // Building up elastic force...
+            Fy = L::add (Fy, L::mul (W, dy));                                                       // Building up elastic force...
+            Fz = L::add (Fz, L::mul (W, dz));                                                       // Building up elastic force...
+            L::store (s, S);                                                                        // Storing link strain...
+            L::store_index (k, j);                                                                  // Storing link index...
+
+            for(l = 0; l < L::lanes; l++)
+            {
+              if((k[l] < j_max[l]) && (((unsigned int)color[k[l]] >> 24) == 255))
+              {
+                color[k[l]] = colormap (0.7f*(1.0f + s[l]/resting[k[l]]), 255);                     // Setting color (opaque links only)...
+              }
+            }
+
+            j  = L::add_index (j, 1);                                                               // Moving to next links...
+            on = L::less (j, j_end);                                                                // Masking finished nodes...
+          }
+
+          L::store (f[0], Fx);                                                                      // Storing force...
+          L::store (f[1], Fy);                                                                      // Storing force...
+          L::store (f[2], Fz);                                                                      // Storing force...
+
+          for(l = 0; l < L::lanes; l++)
+          {
+            obstacle (i + l, f[0][l], f[1][l], f[2][l]);                                            // Adding obstacle reaction...
+          }
+        }
+
+        return i;
+      }
+
+      // Corrector ("thekernel_2.cl") over packs of nodes in [loc_begin, loc_end):
+      template<class V>
+      size_t correct (
+                      size_t loc_begin,                                                             // First node.
+                      size_t loc_end                                                                // Last node + 1.
+                     )
+      {
+        typedef typename V::type P;
+        float  g_rep[16];                                                                           // Gravity (replicated).
+        P      H2 = V::set1 (0.5f*dt[0]);                                                           // Half time step [s].
+        P      B  = V::set1 (friction[0]);                                                          // Friction [kg/s].
+        P      g;                                                                                   // Gravity [m/s^2].
+        P      m;                                                                                   // Mass [kg].
+        P      fr;                                                                                  // Freedom flags.
+        P      v;                                                                                   // Velocity.
+        P      a;                                                                                   // Acceleration.
+        P      F;                                                                                   // Gravity + elastic + contact force.
+        P      a_est;                                                                               // Acceleration (estimation).
+        P      v_est;                                                                               // Velocity (estimation).
+        P      a_new;                                                                               // Acceleration (new).
+        P      v_new;                                                                               // Velocity (new).
+        size_t i;                                                                                   // Node index.
+
+        for(i = 0; i < 4; i++)
+        {
+          g_rep[4*i + 0] = gravity[0].x;                                                            // Replicating gravity...
+          g_rep[4*i + 1] = gravity[0].y;                                                            // Replicating gravity...
+          g_rep[4*i + 2] = gravity[0].z;                                                            // Replicating gravity...
+          g_rep[4*i + 3] = 0.0f;                                                                    // Replicating gravity...
+        }
+
+        g = V::load (g_rep);
+
+        for(i = loc_begin; (i + V::nodes) <= loc_end; i += V::nodes)
+        {
+          m     = V::node (&mass[i]);                                                               // Getting mass...
+          fr    = flags<V>(i);                                                                      // Getting freedom flags...
+          v     = V::load (&velocity[i].x);                                                         // Getting velocity...
+          a     = V::load (&acceleration[i].x);                                                     // Getting acceleration...
+          F     = V::add (V::mul (m, g), V::load (&force[i].x));                                    // Computing non-viscous force...
+          a_est = V::div (V::sub (F, V::mul (B, V::load (&velocity_int[i].x))), m);                 // Computing acceleration (estimation)...
+          v_est = V::add (v, V::mul (H2, V::add (a, a_est)));                                       // Computing velocity (estimation)...
+          a_new = V::mul (V::div (V::sub (F, V::mul (B, v_est)), m), fr);                           // Computing acceleration...
+          v_new = V::mul (V::add (v, V::mul (H2, V::add (a, a_new))), fr);                          // Computing velocity...
+          V::store (&position[i].x, V::load (&position_int[i].x));                                  // Updating position...
+          V::store (&velocity[i].x, V::projective (v_new));                                         // Updating velocity...
+          V::store (&acceleration[i].x, V::projective (a_new));                                     // Updating acceleration...
+        }
+
+        return i;
+      }
+
+    public:
+      /// @brief **Class constructor.**
+      /// @details It binds the solver to the host arrays of the example: they are read and updated
+      /// in place by each step.
+      cpu_solver (
+                  size_t                            loc_threads,                                    // Number of threads.
+                  size_t                            loc_block,                                      // Block size [#].
+                  std::vector<int>&                 loc_color,                                      // Link color (RGBA8).
+                  std::vector<nu_float4_structure>& loc_position,                                   // Position [m].
+                  std::vector<nu_float4_structure>& loc_velocity,                                   // Velocity [m/s].
+                  std::vector<nu_float4_structure>& loc_acceleration,                               // Acceleration [m/s^2].
+                  std::vector<nu_float4_structure>& loc_position_int,                               // Position (intermediate) [m].
+                  std::vector<nu_float4_structure>& loc_velocity_int,                               // Velocity (intermediate) [m/s].
+                  std::vector<nu_float4_structure>& loc_gravity,                                    // Gravity [m/s^2].
+                  std::vector<float>&               loc_stiffness,                                  // Link stiffness [kg/s^2].
+                  std::vector<float>&               loc_resting,                                    // Link resting length [m].
+                  std::vector<float>&               loc_friction,                                   // Friction [kg/s].
+                  std::vector<float>&               loc_mass,                                       // Node mass [kg].
+                  std::vector<int>&                 loc_nearest,                                    // Neighbour indices.
+                  std::vector<int>&                 loc_offset,                                     // Neighbour offsets.
+                  std::vector<int>&                 loc_freedom,                                    // Freedom flags.
+                  std::vector<float>&               loc_dt,                                         // Time step [s].
+                  std::vector<float>&               loc_contact                                     // Contact parameters.
+                 ) :
+        pool (loc_threads),
+        color (loc_color),
+        position (loc_position),
+        velocity (loc_velocity),
+        acceleration (loc_acceleration),
+        position_int (loc_position_int),
+        velocity_int (loc_velocity_int),
+        gravity (loc_gravity),
+        stiffness (loc_stiffness),
+        resting (loc_resting),
+        friction (loc_friction),
+        mass (loc_mass),
+        nearest (loc_nearest),
+        offset (loc_offset),
+        freedom (loc_freedom),
+        dt (loc_dt),
+        contact (loc_contact)
+      {
+        nodes  = loc_position.size ();                                                              // Getting number of nodes...
+        block  = std::max (loc_block/lane_wide::lanes, (size_t)1)*lane_wide::lanes;                 // Rounding block to lanes (and packs)...
+        blocks = (nodes + block - 1)/block;                                                         // Getting number of blocks...
+        force.assign (nodes, {0.0f, 0.0f, 0.0f, 0.0f});                                             // Setting forces...
+      }
+
+      /// @brief **Number of threads.**
+      size_t threads ()
+      {
+        return pool.threads ();
+      }
+
+      /// @brief **Time step.**
+      /// @details It advances the solution by one time step: predictor over all nodes first, then
+      /// forces and corrector (the latter read the intermediate positions of the neighbours).
+      void step ()
+      {
+        pool.run (blocks, [&] (size_t loc_block)
+        {
+          size_t i_max = std::min ((loc_block + 1)*block, nodes);                                   // Block end.
+          size_t i     = predict<simd_wide>(loc_block*block, i_max);                                // Predicting (packs)...
+
+          predict<simd_scalar>(i, i_max);                                                           // Predicting (tail)...
+        });
+
+        pool.run (blocks, [&] (size_t loc_block)
+        {
+          size_t i_min = loc_block*block;                                                           // Block begin.
+          size_t i_max = std::min ((loc_block + 1)*block, nodes);                                   // Block end.
+          size_t i     = gather<lane_wide>(i_min, i_max);                                           // Gathering forces (packs)...
+
+          gather<lane_scalar>(i, i_max);                                                            // Gathering forces (tail)...
+          i = correct<simd_wide>(i_min, i_max);                                                     // Correcting (packs)...
+          correct<simd_scalar>(i, i_max);                                                           // Correcting (tail)...
+        });
+      }
+  };
+}
+
+#endif
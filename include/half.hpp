@@ -0,0 +1,109 @@
+/// @file     half.hpp
+/// @brief    Half precision state packing.
+///
+/// @details  The kernels specialized with "precision_half.cl" keep their intermediate state as
+/// "half4", two nodes per "float4" element. The host sets and restores that state in single
+/// precision: it is packed here (IEEE 754 binary16, rounded to nearest even) right before being
+/// written to the OpenCL buffers.
+
+#ifndef half_hpp
+#define half_hpp
+
+// INCLUDES:
+  #include "nu.hpp"                                                                                 // Neutrino's header file.
+  #include <cstdint>                                                                                // Standard integer types.
+  #include <cstring>                                                                                // Standard C strings.
+
+namespace examples
+{
+  struct half
+  {
+    /// @brief **Bits.**
+    /// @details It returns the binary16 encoding of a single precision value.
+    static uint16_t bits (
+                          float loc_value                                                           // Value.
+                         )
+    {
+      uint32_t x;                                                                                   // Value bits.
+      uint32_t sign;                                                                                // Sign bit.
+      int32_t  exponent;                                                                            // Exponent (binary16 bias).
+      uint32_t mantissa;                                                                            // Mantissa.
+      uint32_t shift;                                                                               // Mantissa shift.
+      uint32_t rest;                                                                                // Rounded off bits.
+      uint32_t h;                                                                                   // Result bits.
+
+      std::memcpy (&x, &loc_value, sizeof (x));                                                     // Getting value bits...
+      sign     = (x >> 16) & 0x8000;                                                                // Getting sign...
+      exponent = (int32_t)((x >> 23) & 0xFF) - 127 + 15;                                            // Rebiasing exponent...
+      mantissa = x & 0x007FFFFF;                                                                    // Getting mantissa...
+
+      if(((x >> 23) & 0xFF) == 0xFF)
+      {
+        return (uint16_t)(sign | 0x7C00 | ((mantissa != 0) ? 0x0200 : 0));                          // Infinity or NaN...
+      }
+
+      if(exponent >= 31)
+      {
+        return (uint16_t)(sign | 0x7C00);                                                           // Overflowing to infinity...
+      }
+
+      if(exponent <= 0)
+      {
+        if(exponent < -10)
+        {
+          return (uint16_t)sign;                                                                    // Underflowing to zero...
+        }
+
+        mantissa |= 0x00800000;                                                                     // Restoring implicit bit...
+        shift     = (uint32_t)(14 - exponent);                                                      // Denormalizing...
+      }
+      else
+      {
+        mantissa |= (uint32_t)exponent << 23;                                                       // Merging exponent...
+        shift     = 13;                                                                             // Normalized shift...
+      }
+
+      h    = mantissa >> shift;                                                                     // Truncating...
+      rest = mantissa & ((1u << shift) - 1);                                                        // Getting rounded off bits...
+
+      if((rest > (1u << (shift - 1))) || ((rest == (1u << (shift - 1))) && ((h & 1) != 0)))
+      {
+        h++;                                                                                        // Rounding to nearest even (may carry into exponent)...
+      }
+
+      return (uint16_t)(sign | h);
+    }
+
+    /// @brief **Pack.**
+    /// @details It packs a per-node "float4" state as "half4", two nodes per element (the last
+    /// element is padded with zeros if the number of nodes is odd).
+    static std::vector<nu_float4_structure> pack (
+                                                  const std::vector<nu_float4_structure>& loc_state // State.
+                                                 )
+    {
+      std::vector<nu_float4_structure> packed ((loc_state.size () + 1)/2, {0.0f, 0.0f, 0.0f, 0.0f});
+      uint16_t                         h[8];                                                        // Element halves.
+      size_t                           i;                                                           // Element index.
+      size_t                           k;                                                           // Node index.
+
+      for(i = 0; i < packed.size (); i++)
+      {
+        std::memset (h, 0, sizeof (h));                                                             // Padding...
+
+        for(k = 2*i; (k < 2*i + 2) && (k < loc_state.size ()); k++)
+        {
+          h[4*(k - 2*i) + 0] = bits (loc_state[k].x);                                               // Packing "x"...
+          h[4*(k - 2*i) + 1] = bits (loc_state[k].y);                                               // Packing "y"...
+          h[4*(k - 2*i) + 2] = bits (loc_state[k].z);                                               // Packing "z"...
+          h[4*(k - 2*i) + 3] = bits (loc_state[k].w);                                               // Packing "w"...
+        }
+
+        std::memcpy (&packed[i], h, sizeof (h));                                                    // Storing element...
+      }
+
+      return packed;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,105 @@
+/// @file     input_log.hpp
+/// @brief    Per-frame input log.
+///
+/// @details  An interactive run depends on how the view is moved and on when the buttons are hit.
+/// Here the buttons and the camera state (view and projection matrices, aspect ratio, viewport, as
+/// returned by "link_renderer::camera") of every frame are written to a text file, one frame per
+/// line, or read back from it: driving the same loop from the log, at a fixed number of simulation
+/// steps per frame, repeats the run frame by frame on any machine.
+
+#ifndef input_log_hpp
+#define input_log_hpp
+
+// INCLUDES:
+  #include <vector>                                                                                 // Standard vector.
+  #include <string>                                                                                 // Standard strings.
+  #include <fstream>                                                                                // Standard file streams.
+  #include <sstream>                                                                                // Standard string streams.
+  #include <iostream>                                                                               // Standard streams.
+  #include <limits>                                                                                 // Standard numeric limits.
+
+namespace examples
+{
+  // FRAME INPUT:
+  typedef struct
+  {
+    bool               cross;                                                                       // "CROSS" button.
+    bool               triangle;                                                                    // "TRIANGLE" button.
+    bool               circle;                                                                      // "CIRCLE" button.
+    bool               square;                                                                      // "SQUARE" button.
+    std::vector<float> camera;                                                                      // Camera state.
+  } input;
+
+  class input_log
+  {
+    private:
+      std::fstream file;                                                                            // Log file.
+
+    public:
+      /// @brief **Class constructor.**
+      /// @details It opens the log for writing, or for reading if "loc_replay" is "true".
+      input_log (
+                 std::string loc_path,                                                              // Log file.
+                 bool        loc_replay                                                             // "true" = read the log.
+                )
+      {
+        file.open (loc_path, loc_replay ? std::ios::in : (std::ios::out | std::ios::trunc));        // Opening log...
+
+        if(!file.is_open ())
+        {
+          std::cout << "Error: unable to open input log " << loc_path << std::endl;                 // Printing message...
+          exit (EXIT_FAILURE);                                                                      // Exiting...
+        }
+
+        file.precision (std::numeric_limits<float>::max_digits10);                                  // Setting lossless float precision...
+      }
+
+      /// @brief **Write.**
+      /// @details It appends the input of one frame.
+      void write (
+                  const input& loc_input                                                            // Frame input.
+                 )
+      {
+        file << loc_input.cross << " " << loc_input.triangle << " " << loc_input.circle << " "
+             << loc_input.square << " " << loc_input.camera.size ();                                // Writing buttons...
+
+        for(float value : loc_input.camera)
+        {
+          file << " " << value;                                                                     // Writing camera state...
+        }
+
+        file << "\n";                                                                               // Ending frame...
+      }
+
+      /// @brief **Read.**
+      /// @details It reads the input of the next frame, returning "false" at the end of the log.
+      bool read (
+                 input& loc_input                                                                   // Frame input.
+                )
+      {
+        std::string        line;                                                                    // Frame line.
+        std::istringstream text;                                                                    // Frame text.
+        size_t             size;                                                                    // Camera state size.
+        size_t             i;                                                                       // Index.
+
+        if(!std::getline (file, line))
+        {
+          return false;
+        }
+
+        text.str (line);                                                                            // Setting frame text...
+        text >> loc_input.cross >> loc_input.triangle >> loc_input.circle >> loc_input.square;      // Reading buttons...
+        text >> size;                                                                               // Reading camera state size...
+        loc_input.camera.resize (size);                                                             // Sizing camera state...
+
+        for(i = 0; i < size; i++)
+        {
+          text >> loc_input.camera[i];                                                              // Reading camera state...
+        }
+
+        return !text.fail ();
+      }
+  };
+}
+
+#endif
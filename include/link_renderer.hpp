@@ -0,0 +1,316 @@
+/// @file     link_renderer.hpp
+/// @brief    Instanced link renderer.
+///
+/// @details  The links used to be drawn by a geometry shader that transformed both nodes of every
+/// link and emitted its billboard one primitive at a time. Here a compute pass transforms each node
+/// to clip space once, then the links are drawn as one instanced triangle strip: each instance is a
+/// link and its 4 vertices are the billboard corners, generated in the vertex shader from the
+/// clip-space nodes. The camera matrices are the ones Neutrino has just set on its own shader
+/// program, hence "plot" must be called right after "nu::opengl::plot". The examples build that
+/// program (the "voxel" shaders) with no points: it draws nothing and only holds the camera.
+///
+/// Before drawing, a culling pass compacts the visible links in a list and counts them straight
+/// into an indirect draw command: links whose nodes both lie beyond the same clip plane are
+/// dropped, and links projected shorter than a pixel threshold are thinned out in proportion to
+/// their length (a fixed, per-link subset, so that the picture does not flicker while navigating).
+/// The draw cost then follows the screen coverage rather than the mesh size. Each visible link is
+/// listed with its central node and billboard aspect ratio, found once there: every vertex then
+/// computes only its own corner.
+
+#ifndef link_renderer_hpp
+#define link_renderer_hpp
+
+// INCLUDES:
+  #include "nu.hpp"                                                                                 // Neutrino's header file.
+  #include <fstream>                                                                                // Standard file streams.
+  #include <sstream>                                                                                // Standard string streams.
+  #include <algorithm>                                                                              // Standard algorithms.
+  #include <vector>                                                                                 // Standard vector.
+  #include <string>                                                                                 // Standard string.
+
+namespace examples
+{
+  class link_renderer
+  {
+    private:
+      GLuint transform;                                                                             // Node transform program (compute).
+      GLuint cull;                                                                                  // Link culling program (compute).
+      GLuint draw;                                                                                  // Link draw program (vertex + fragment).
+      GLuint clip;                                                                                  // Clip-space node buffer object.
+      GLuint visible;                                                                               // Visible link buffer object.
+      GLuint command;                                                                               // Indirect draw command buffer object.
+      GLuint binding;                                                                               // Clip-space node SSBO binding point.
+      float  pixels;                                                                                // Link LOD threshold [px].
+      GLuint vao;                                                                                   // Empty vertex array object.
+      size_t size;                                                                                  // Clip-space node buffer size [bytes].
+      size_t capacity;                                                                              // Visible link buffer size [bytes].
+
+      // Compiling shader stage:
+      GLuint compile (
+                      std::string loc_path,                                                         // Shader source file.
+                      GLenum      loc_type,                                                         // Shader type.
+                      std::string loc_defines = ""                                                  // Definitions (after the version line).
+                     )
+      {
+        std::ifstream     file (loc_path);                                                          // Source file.
+        std::stringstream text;                                                                     // Source text.
+        std::string       source;                                                                   // Source string.
+        const char*       code;                                                                     // Source code.
+        GLuint            stage;                                                                    // Shader stage.
+        GLint             success;                                                                  // Compilation flag.
+        GLchar            log[1024];                                                                // Compilation log.
+
+        if(!file.is_open ())
+        {
+          std::cout << "Error: unable to open shader source " << loc_path << std::endl;             // Printing message...
+          exit (EXIT_FAILURE);                                                                      // Exiting...
+        }
+
+        text << file.rdbuf ();                                                                      // Reading source...
+        source = text.str ();                                                                       // Getting source...
+
+        if(!loc_defines.empty () && (source.find ("#version") != std::string::npos))
+        {
+          source.insert (source.find ('\n', source.find ("#version")) + 1, loc_defines);             // Inserting definitions...
+        }
+
+        code   = source.c_str ();                                                                   // Getting source code...
+        stage  = glCreateShader (loc_type);                                                         // Creating shader stage...
+        glShaderSource (stage, 1, &code, NULL);                                                     // Attaching source...
+        glCompileShader (stage);                                                                    // Compiling shader stage...
+        glGetShaderiv (stage, GL_COMPILE_STATUS, &success);                                         // Getting compilation flag...
+
+        if(!success)
+        {
+          glGetShaderInfoLog (stage, sizeof(log), NULL, log);                                       // Getting compilation log...
+          std::cout << "Error: unable to compile " << loc_path << std::endl << log << std::endl;    // Printing message...
+          exit (EXIT_FAILURE);                                                                      // Exiting...
+        }
+
+        return stage;
+      }
+
+      // Linking shader program:
+      GLuint link (
+                   std::vector<GLuint> loc_stage                                                    // Shader stages.
+                  )
+      {
+        GLuint program = glCreateProgram ();                                                        // Shader program.
+        GLint  success;                                                                             // Linking flag.
+        GLchar log[1024];                                                                           // Linking log.
+        size_t i;                                                                                   // Index.
+
+        for(i = 0; i < loc_stage.size (); i++)
+        {
+          glAttachShader (program, loc_stage[i]);                                                   // Attaching shader stage...
+        }
+
+        glLinkProgram (program);                                                                    // Linking shader program...
+        glGetProgramiv (program, GL_LINK_STATUS, &success);                                         // Getting linking flag...
+
+        if(!success)
+        {
+          glGetProgramInfoLog (program, sizeof(log), NULL, log);                                    // Getting linking log...
+          std::cout << "Error: unable to link shader program" << std::endl << log << std::endl;     // Printing message...
+          exit (EXIT_FAILURE);                                                                      // Exiting...
+        }
+
+        for(i = 0; i < loc_stage.size (); i++)
+        {
+          glDeleteShader (loc_stage[i]);                                                            // Deleting shader stage...
+        }
+
+        return program;
+      }
+
+    public:
+      /// @brief **Definition.**
+      /// @details It returns the shader definition of "loc_name" as "loc_value".
+      static std::string define (
+                                 std::string loc_name,                                              // Definition name.
+                                 int         loc_value                                              // Definition value.
+                                )
+      {
+        return "#define " + loc_name + " " + std::to_string (loc_value) + "\n";
+      }
+
+      /// @brief **Class constructor.**
+      /// @details It builds the node transform and link culling (compute) and the link draw
+      /// (vertex + fragment) programs. The link shaders ("include/shader") are shared by the
+      /// examples: "loc_defines" gives them the bindings of the example buffers (POSITION_BINDING,
+      /// COLOR_BINDING, NEAREST_BINDING, CENTRAL_BINDING or OFFSET_BINDING) and the color format
+      /// (COLOR_RGBA8). The clip-space nodes, the visible links and the draw command are exchanged
+      /// through the SSBOs at "loc_binding", "loc_binding + 1" and "loc_binding + 2".
+      link_renderer (
+                     std::string loc_compute,                                                       // Node transform shader source file.
+                     std::string loc_cull,                                                          // Link culling shader source file.
+                     std::string loc_vertex,                                                        // Link vertex shader source file.
+                     std::string loc_fragment,                                                      // Link fragment shader source file.
+                     std::string loc_defines,                                                       // Example buffer definitions.
+                     GLuint      loc_binding,                                                       // Clip-space node SSBO binding point.
+                     float       loc_pixels                                                         // Link LOD threshold [px].
+                    )
+      {
+        std::string defines = loc_defines +
+                              define ("CLIP_BINDING", (int)loc_binding) +
+                              define ("VISIBLE_BINDING", (int)loc_binding + 1) +
+                              define ("COMMAND_BINDING", (int)loc_binding + 2);                     // Shader definitions.
+
+        transform = link ({compile (loc_compute, GL_COMPUTE_SHADER, defines)});                     // Building transform program...
+        cull      = link ({compile (loc_cull, GL_COMPUTE_SHADER, defines)});                        // Building culling program...
+        draw      = link ({compile (loc_vertex, GL_VERTEX_SHADER, defines),
+                           compile (loc_fragment, GL_FRAGMENT_SHADER)});                            // Building draw program...
+        binding   = loc_binding;                                                                    // Setting binding point...
+        pixels    = loc_pixels;                                                                     // Setting LOD threshold...
+        size      = 0;                                                                              // Setting size...
+        capacity  = 0;                                                                              // Setting capacity...
+        glGenBuffers (1, &clip);                                                                    // Generating clip-space node buffer...
+        glGenBuffers (1, &visible);                                                                 // Generating visible link buffer...
+        glGenBuffers (1, &command);                                                                 // Generating draw command buffer...
+        glBindBuffer (GL_DRAW_INDIRECT_BUFFER, command);                                            // Binding draw command buffer...
+        glBufferData (GL_DRAW_INDIRECT_BUFFER, 4*sizeof(GLuint), NULL, GL_DYNAMIC_DRAW);            // Allocating draw command buffer...
+        glBindBuffer (GL_DRAW_INDIRECT_BUFFER, 0);                                                  // Unbinding draw command buffer...
+        glGenVertexArrays (1, &vao);                                                                // Generating vertex array...
+      }
+
+      /// @brief **Camera.**
+      /// @details It returns the camera state Neutrino has just set on its own program: view
+      /// matrix, projection matrix, aspect ratio and viewport (empty if no program is current).
+      std::vector<float> camera ()
+      {
+        GLint              program;                                                                 // Neutrino's shader program.
+        GLint              viewport[4];                                                             // Viewport [px].
+        std::vector<float> state (16 + 16 + 1 + 4);                                                 // Camera state.
+        size_t             i;                                                                       // Index.
+
+        glGetIntegerv (GL_CURRENT_PROGRAM, &program);                                               // Getting Neutrino's program...
+
+        if(program == 0)
+        {
+          return std::vector<float> ();
+        }
+
+        glGetUniformfv (program, glGetUniformLocation (program, "V_mat"), &state[0]);               // Getting view matrix...
+        glGetUniformfv (program, glGetUniformLocation (program, "P_mat"), &state[16]);              // Getting projection matrix...
+        glGetUniformfv (program, glGetUniformLocation (program, "AR"), &state[32]);                 // Getting aspect ratio...
+        glGetIntegerv (GL_VIEWPORT, viewport);                                                      // Getting viewport...
+
+        for(i = 0; i < 4; i++)
+        {
+          state[33 + i] = (float)viewport[i];                                                       // Setting viewport...
+        }
+
+        return state;
+      }
+
+      /// @brief **Camera (setting).**
+      /// @details It overrides the camera state on the program left current by
+      /// "nu::opengl::plot" with one previously returned by "camera ()": view matrix, projection
+      /// matrix and aspect ratio (the viewport is the one of the window).
+      void camera (
+                   const std::vector<float>& loc_state                                              // Camera state.
+                  )
+      {
+        GLint program;                                                                              // Neutrino's shader program.
+
+        glGetIntegerv (GL_CURRENT_PROGRAM, &program);                                               // Getting Neutrino's program...
+
+        if((program == 0) || (loc_state.size () < 33))
+        {
+          return;
+        }
+
+        glUniformMatrix4fv (glGetUniformLocation (program, "V_mat"), 1, GL_FALSE, &loc_state[0]);   // Setting view matrix...
+        glUniformMatrix4fv (glGetUniformLocation (program, "P_mat"), 1, GL_FALSE, &loc_state[16]);  // Setting projection matrix...
+        glUniform1f (glGetUniformLocation (program, "AR"), loc_state[32]);                          // Setting aspect ratio...
+      }
+
+      /// @brief **Plot.**
+      /// @details It transforms "loc_nodes" nodes, culls "loc_links" links and draws the visible
+      /// ones, reading the camera matrices and the aspect ratio from the program left current by
+      /// "nu::opengl::plot".
+      void plot (
+                 size_t loc_nodes,                                                                  // Number of nodes.
+                 size_t loc_links                                                                   // Number of links.
+                )
+      {
+        GLint              program;                                                                 // Neutrino's shader program.
+        std::vector<float> state = camera ();                                                       // Camera state.
+        GLuint             reset[4] = {4, 0, 0, 0};                                                 // Empty draw command (4 vertices, 0 instances).
+        size_t             bytes    = loc_nodes*4*sizeof(GLfloat);                                  // Clip-space node buffer size [bytes].
+        size_t             list     = std::max (loc_links, (size_t)1)*4*sizeof(GLuint);             // Visible link buffer size [bytes].
+
+        if(state.empty ())
+        {
+          return;
+        }
+
+        glGetIntegerv (GL_CURRENT_PROGRAM, &program);                                               // Getting Neutrino's program...
+
+        // ALLOCATING CLIP-SPACE NODES:
+        if(bytes != size)
+        {
+          glBindBuffer (GL_SHADER_STORAGE_BUFFER, clip);                                            // Binding buffer...
+          glBufferData (GL_SHADER_STORAGE_BUFFER, bytes, NULL, GL_DYNAMIC_COPY);                    // Allocating buffer...
+          glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);                                               // Unbinding buffer...
+          size = bytes;                                                                             // Setting size...
+        }
+
+        if(list != capacity)
+        {
+          glBindBuffer (GL_SHADER_STORAGE_BUFFER, visible);                                         // Binding buffer...
+          glBufferData (GL_SHADER_STORAGE_BUFFER, list, NULL, GL_DYNAMIC_COPY);                     // Allocating buffer...
+          glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);                                               // Unbinding buffer...
+          capacity = list;                                                                          // Setting capacity...
+        }
+
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, binding, clip);                                 // Attaching clip-space nodes...
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, binding + 1, visible);                          // Attaching visible links...
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, binding + 2, command);                          // Attaching draw command...
+
+        // TRANSFORMING NODES (once per node):
+        glUseProgram (transform);                                                                   // Using transform program...
+        glUniformMatrix4fv (glGetUniformLocation (transform, "V_mat"), 1, GL_FALSE, &state[0]);     // Setting view matrix...
+        glUniformMatrix4fv (glGetUniformLocation (transform, "P_mat"), 1, GL_FALSE, &state[16]);    // Setting projection matrix...
+        glUniform1ui (glGetUniformLocation (transform, "nodes"), (GLuint)loc_nodes);                // Setting number of nodes...
+        glDispatchCompute ((GLuint)((loc_nodes + 63)/64), 1, 1);                                    // Transforming nodes...
+        glMemoryBarrier (GL_SHADER_STORAGE_BARRIER_BIT);                                            // Waiting for clip-space nodes...
+
+        // CULLING LINKS (compacting the visible ones):
+        glBindBuffer (GL_DRAW_INDIRECT_BUFFER, command);                                            // Binding draw command buffer...
+        glBufferSubData (GL_DRAW_INDIRECT_BUFFER, 0, sizeof(reset), reset);                         // Resetting draw command...
+        glUseProgram (cull);                                                                        // Using culling program...
+        glUniformMatrix4fv (glGetUniformLocation (cull, "P_mat"), 1, GL_FALSE, &state[16]);         // Setting projection matrix...
+        glUniform1f (glGetUniformLocation (cull, "AR"), state[32]);                                 // Setting aspect ratio...
+        glUniform1ui (glGetUniformLocation (cull, "links"), (GLuint)loc_links);                     // Setting number of links...
+        glUniform2f (glGetUniformLocation (cull, "viewport"), state[35], state[36]);                // Setting viewport size...
+        glUniform1f (glGetUniformLocation (cull, "pixels"), pixels);                                // Setting LOD threshold...
+        glDispatchCompute ((GLuint)((loc_links + 63)/64), 1, 1);                                    // Culling links...
+        glMemoryBarrier (GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);                   // Waiting for visible links...
+
+        // DRAWING VISIBLE LINKS (one instance per link, 4 billboard vertices each):
+        glUseProgram (draw);                                                                        // Using draw program...
+        glUniformMatrix4fv (glGetUniformLocation (draw, "P_mat"), 1, GL_FALSE, &state[16]);         // Setting projection matrix...
+        glUniform1f (glGetUniformLocation (draw, "AR"), state[32]);                                 // Setting aspect ratio...
+        glBindVertexArray (vao);                                                                    // Binding vertex array...
+        glDrawArraysIndirect (GL_TRIANGLE_STRIP, NULL);                                             // Drawing visible links...
+        glBindVertexArray (0);                                                                      // Unbinding vertex array...
+        glBindBuffer (GL_DRAW_INDIRECT_BUFFER, 0);                                                  // Unbinding draw command buffer...
+        glUseProgram (program);                                                                     // Restoring Neutrino's program...
+      }
+
+      /// @brief **Class destructor.**
+      ~link_renderer ()
+      {
+        glDeleteProgram (transform);                                                                // Deleting transform program...
+        glDeleteProgram (cull);                                                                     // Deleting culling program...
+        glDeleteProgram (draw);                                                                     // Deleting draw program...
+        glDeleteBuffers (1, &clip);                                                                 // Deleting clip-space node buffer...
+        glDeleteBuffers (1, &visible);                                                              // Deleting visible link buffer...
+        glDeleteBuffers (1, &command);                                                              // Deleting draw command buffer...
+        glDeleteVertexArrays (1, &vao);                                                             // Deleting vertex array...
+      }
+  };
+}
+
+#endif
@@ -0,0 +1,102 @@
+/// @file     patches.hpp
+/// @brief    Sparse parameter patches.
+///
+/// @details  Editing a device parameter (a freedom flag, the stiffness of a link...) by changing
+/// the host vector and writing it again uploads the whole buffer. Here the edits are queued instead
+/// as (index, value) pairs, one queue per target buffer: an edit to an index already queued replaces
+/// the previous one, so that the edits of a frame are coalesced. The queue is locked, so that edits
+/// can be queued by the render thread while the simulation thread takes them in chunks and scatters
+/// them on the device by a small kernel. Each chunk uploads the whole patch buffers (PATCH_MAX
+/// entries, whatever the number of patches it holds): the cost of an edit is proportional to its
+/// number of chunks, not to the size of the mesh.
+
+#ifndef patches_hpp
+#define patches_hpp
+
+// INCLUDES:
+  #include <vector>                                                                                 // Standard vector.
+  #include <map>                                                                                    // Standard map.
+  #include <mutex>                                                                                  // Standard mutexes.
+  #include <atomic>                                                                                 // Standard atomics.
+  #include <cstddef>                                                                                // Standard size types.
+
+namespace examples
+{
+  class patches
+  {
+    private:
+      std::mutex                        lock;                                                       // Queue lock.
+      std::vector<std::map<int, float>> queue;                                                      // Queued patches (per target).
+
+    public:
+      std::atomic<size_t>               queued  {0};                                                // Queued edits (coalesced) [#].
+      std::atomic<size_t>               applied {0};                                                // Applied patches (coalesced) [#].
+
+      /// @brief **Class constructor.**
+      /// @details It sets one empty queue per target buffer.
+      patches (
+               size_t loc_targets                                                                   // Number of targets [#].
+              )
+      {
+        queue.resize (loc_targets);                                                                 // Setting queues...
+      }
+
+      /// @brief **Set.**
+      /// @details It queues the edit "loc_value" at "loc_index" of target "loc_target", replacing
+      /// the one already queued there (if any): only edits to a new index are counted as queued.
+      void set (
+                size_t loc_target,                                                                  // Target.
+                int    loc_index,                                                                   // Index.
+                float  loc_value                                                                    // Value.
+               )
+      {
+        std::lock_guard<std::mutex> guard (lock);
+
+        if(queue[loc_target].insert_or_assign (loc_index, loc_value).second)
+        {
+          queued++;                                                                                 // Counting edit (new index)...
+        }
+      }
+
+      /// @brief **Take.**
+      /// @details It moves the patches queued for "loc_target" into "loc_index" and "loc_value",
+      /// as many as their size (the patch capacity), and returns how many have been moved: the
+      /// remaining ones are left for the next call.
+      size_t take (
+                   size_t              loc_target,                                                  // Target.
+                   std::vector<int>&   loc_index,                                                   // Patch indices.
+                   std::vector<float>& loc_value                                                    // Patch values.
+                  )
+      {
+        std::lock_guard<std::mutex> guard (lock);
+        size_t                      count = 0;                                                      // Moved patches [#].
+        auto                        it    = queue[loc_target].begin ();                             // Queue iterator.
+
+        while((it != queue[loc_target].end ()) && (count < loc_index.size ()))
+        {
+          loc_index[count] = it->first;                                                             // Moving index...
+          loc_value[count] = it->second;                                                            // Moving value...
+          it               = queue[loc_target].erase (it);                                          // Dequeueing patch...
+          count++;                                                                                  // Counting patch...
+        }
+
+        applied += count;                                                                           // Counting applied patches...
+
+        return count;
+      }
+
+      /// @brief **Clear.**
+      /// @details It drops all queued patches.
+      void clear ()
+      {
+        std::lock_guard<std::mutex> guard (lock);
+
+        for(auto& target : queue)
+        {
+          target.clear ();                                                                          // Dropping patches...
+        }
+      }
+  };
+}
+
+#endif
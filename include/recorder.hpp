@@ -0,0 +1,297 @@
+/// @file     recorder.hpp
+/// @brief    Offscreen frame recorder.
+///
+/// @details  The frames are rendered into an offscreen framebuffer and read back through a ring of
+/// pixel buffer objects: "glReadPixels" into a bound pixel buffer returns at once, and a fence tells
+/// when the copy is over, so a slot is mapped only a few frames later, when its data is already
+/// there, and the GL pipeline never waits for the readback. The mapped pixels are handed to a worker
+/// thread which writes them as a binary PPM image sequence ("<prefix>000000.ppm", ...), keeping the
+/// disk out of the rendering thread. Nothing here needs more than OpenGL 3.2, hence it also runs on
+/// a software rasterizer (e.g. Mesa llvmpipe).
+
+#ifndef recorder_hpp
+#define recorder_hpp
+
+// INCLUDES:
+  #include "nu.hpp"                                                                                 // Neutrino's header file.
+  #include <vector>                                                                                 // Standard vector.
+  #include <deque>                                                                                  // Standard double-ended queue.
+  #include <string>                                                                                 // Standard strings.
+  #include <thread>                                                                                 // Standard threads.
+  #include <mutex>                                                                                  // Standard mutexes.
+  #include <condition_variable>                                                                     // Standard condition variables.
+  #include <fstream>                                                                                // Standard file streams.
+  #include <sstream>                                                                                // Standard string streams.
+  #include <iomanip>                                                                                // Standard stream manipulators.
+  #include <cstring>                                                                                // Standard C strings.
+
+namespace examples
+{
+  class recorder
+  {
+    private:
+      typedef struct
+      {
+        size_t                     number;                                                          // Frame number [#].
+        std::vector<unsigned char> pixels;                                                          // Frame pixels (RGBA8, bottom-up).
+      } frame;
+
+      GLuint                  fbo;                                                                  // Framebuffer object.
+      GLuint                  color;                                                                // Color renderbuffer.
+      GLuint                  depth;                                                                // Depth renderbuffer.
+      GLsizei                 width;                                                                // Frame width [px].
+      GLsizei                 height;                                                               // Frame height [px].
+      std::vector<GLuint>     pbo;                                                                  // Pixel buffer ring.
+      std::vector<GLsync>     fence;                                                                // Readback fences (per slot).
+      std::vector<size_t>     number;                                                               // Frame numbers (per slot).
+      size_t                  head;                                                                 // Next slot.
+      size_t                  busy;                                                                 // Slots in flight [#].
+      size_t                  captured;                                                             // Captured frames [#].
+      size_t                  depth_max;                                                            // Worker queue capacity [#].
+      std::string             prefix;                                                               // Image file prefix.
+      std::deque<frame>       queue;                                                                // Frames to be written.
+      std::mutex              lock;                                                                 // Queue lock.
+      std::condition_variable changed;                                                              // Queue change signal.
+      std::thread             worker;                                                               // Writer thread.
+      bool                    stop;                                                                 // Writer stop request.
+
+      // Writing frame as binary PPM (rows flipped, OpenGL rows start from the bottom):
+      void write (
+                  const frame& loc_frame                                                            // Frame.
+                 )
+      {
+        std::ostringstream         name;                                                            // File name.
+        std::vector<unsigned char> row (3*width);                                                   // RGB row.
+        GLsizei                    x;                                                               // Column index.
+        GLsizei                    y;                                                               // Row index.
+
+        name << prefix << std::setw (6) << std::setfill ('0') << loc_frame.number << ".ppm";        // Building file name...
+        std::ofstream file (name.str (), std::ios::binary);                                         // Image file.
+
+        if(!file.is_open ())
+        {
+          std::cout << "Error: unable to open " << name.str () << std::endl;                        // Printing message...
+          return;
+        }
+
+        file << "P6\n" << width << " " << height << "\n255\n";                                      // Writing header...
+
+        for(y = height - 1; y >= 0; y--)
+        {
+          for(x = 0; x < width; x++)
+          {
+            row[3*x + 0] = loc_frame.pixels[4*(y*width + x) + 0];                                   // Copying red...
+            row[3*x + 1] = loc_frame.pixels[4*(y*width + x) + 1];                                   // Copying green...
+            row[3*x + 2] = loc_frame.pixels[4*(y*width + x) + 2];                                   // Copying blue...
+          }
+
+          file.write ((const char*)row.data (), row.size ());                                       // Writing row...
+        }
+      }
+
+      // Collecting the oldest slot in flight (waiting for its fence only if "loc_wait"):
+      bool collect (
+                    bool loc_wait                                                                   // "true" = wait for the fence.
+                   )
+      {
+        size_t  slot = (head + pbo.size () - busy)%pbo.size ();                                     // Oldest slot.
+        GLenum  status;                                                                             // Fence status.
+        frame   done;                                                                               // Frame.
+        void*   data;                                                                               // Mapped pixels.
+
+        if(busy == 0)
+        {
+          return false;
+        }
+
+        status = glClientWaitSync (
+                                   fence[slot],
+                                   GL_SYNC_FLUSH_COMMANDS_BIT,
+                                   loc_wait ? GL_TIMEOUT_IGNORED : 0
+                                  );                                                                // Checking fence...
+
+        if(status == GL_TIMEOUT_EXPIRED)
+        {
+          return false;
+        }
+
+        done.number = number[slot];                                                                 // Setting frame number...
+        done.pixels.resize (4*width*height);                                                        // Sizing frame...
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[slot]);                                             // Binding slot...
+        data = glMapBufferRange (GL_PIXEL_PACK_BUFFER, 0, done.pixels.size (), GL_MAP_READ_BIT);    // Mapping slot...
+
+        if(data != nullptr)
+        {
+          std::memcpy (done.pixels.data (), data, done.pixels.size ());                             // Copying pixels...
+          glUnmapBuffer (GL_PIXEL_PACK_BUFFER);                                                     // Unmapping slot...
+        }
+
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);                                                     // Unbinding slot...
+        glDeleteSync (fence[slot]);                                                                 // Deleting fence...
+        busy--;                                                                                     // Releasing slot...
+
+        std::unique_lock<std::mutex> guard (lock);
+        changed.wait (guard, [&]{return queue.size () < depth_max;});                               // Waiting for queue room...
+        queue.push_back (std::move (done));                                                         // Queueing frame...
+        changed.notify_all ();                                                                      // Waking writer...
+
+        return true;
+      }
+
+    public:
+      /// @brief **Class constructor.**
+      /// @details It creates the offscreen framebuffer, "loc_slots" pixel buffers and the writer
+      /// thread, which holds at most "loc_queue" frames waiting to be written.
+      recorder (
+                GLsizei     loc_width,                                                              // Frame width [px].
+                GLsizei     loc_height,                                                             // Frame height [px].
+                size_t      loc_slots,                                                              // Pixel buffer ring size [#].
+                size_t      loc_queue,                                                              // Worker queue capacity [#].
+                std::string loc_prefix                                                              // Image file prefix.
+               )
+      {
+        size_t i;                                                                                   // Index.
+
+        width     = loc_width;                                                                      // Setting width...
+        height    = loc_height;                                                                     // Setting height...
+        prefix    = loc_prefix;                                                                     // Setting prefix...
+        depth_max = loc_queue;                                                                      // Setting queue capacity...
+        head      = 0;                                                                              // Setting next slot...
+        busy      = 0;                                                                              // Setting slots in flight...
+        captured  = 0;                                                                              // Setting captured frames...
+        stop      = false;                                                                          // Setting stop request...
+
+        glGenFramebuffers (1, &fbo);                                                                // Generating framebuffer...
+        glGenRenderbuffers (1, &color);                                                             // Generating color renderbuffer...
+        glGenRenderbuffers (1, &depth);                                                             // Generating depth renderbuffer...
+        glBindRenderbuffer (GL_RENDERBUFFER, color);                                                // Binding color renderbuffer...
+        glRenderbufferStorage (GL_RENDERBUFFER, GL_RGBA8, width, height);                           // Allocating color renderbuffer...
+        glBindRenderbuffer (GL_RENDERBUFFER, depth);                                                // Binding depth renderbuffer...
+        glRenderbufferStorage (GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);                // Allocating depth renderbuffer...
+        glBindRenderbuffer (GL_RENDERBUFFER, 0);                                                    // Unbinding renderbuffer...
+        glBindFramebuffer (GL_FRAMEBUFFER, fbo);                                                    // Binding framebuffer...
+        glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);   // Attaching color...
+        glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+        if(glCheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+          std::cout << "Error: incomplete offscreen framebuffer" << std::endl;                      // Printing message...
+          exit (EXIT_FAILURE);                                                                      // Exiting...
+        }
+
+        glBindFramebuffer (GL_FRAMEBUFFER, 0);                                                      // Unbinding framebuffer...
+
+        pbo.resize (loc_slots);                                                                     // Sizing pixel buffer ring...
+        fence.resize (loc_slots, nullptr);                                                          // Sizing fences...
+        number.resize (loc_slots, 0);                                                               // Sizing frame numbers...
+        glGenBuffers ((GLsizei)loc_slots, pbo.data ());                                             // Generating pixel buffers...
+
+        for(i = 0; i < loc_slots; i++)
+        {
+          glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[i]);                                              // Binding slot...
+          glBufferData (GL_PIXEL_PACK_BUFFER, 4*width*height, NULL, GL_STREAM_READ);                // Allocating slot...
+        }
+
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);                                                     // Unbinding slot...
+
+        worker = std::thread ([this] ()
+        {
+          frame next;                                                                               // Frame.
+
+          while(true)
+          {
+            {
+              std::unique_lock<std::mutex> guard (lock);
+              changed.wait (guard, [&]{return stop || !queue.empty ();});                           // Waiting for frames...
+
+              if(queue.empty ())
+              {
+                return;                                                                             // Stopping (queue drained)...
+              }
+
+              next = std::move (queue.front ());                                                    // Taking frame...
+              queue.pop_front ();                                                                   // Dequeueing frame...
+              changed.notify_all ();                                                                // Signaling queue room...
+            }
+
+            write (next);                                                                           // Writing frame...
+          }
+        });
+      }
+
+      /// @brief **Bind.**
+      /// @details It redirects the rendering of the next frame to the offscreen framebuffer.
+      void bind ()
+      {
+        glBindFramebuffer (GL_FRAMEBUFFER, fbo);                                                    // Binding framebuffer...
+        glViewport (0, 0, width, height);                                                           // Setting viewport...
+      }
+
+      /// @brief **Capture.**
+      /// @details It starts the readback of the frame just rendered into the next slot of the ring
+      /// (collecting that slot first if it is still in flight), hands the completed slots to the
+      /// writer, then copies the frame on the window for preview and restores the window as target.
+      void capture ()
+      {
+        if(busy == pbo.size ())
+        {
+          collect (true);                                                                           // Freeing oldest slot...
+        }
+
+        glBindFramebuffer (GL_READ_FRAMEBUFFER, fbo);                                               // Binding framebuffer (read)...
+        glReadBuffer (GL_COLOR_ATTACHMENT0);                                                        // Selecting color attachment...
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, pbo[head]);                                             // Binding slot...
+        glReadPixels (0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);                           // Starting readback...
+        glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);                                                     // Unbinding slot...
+        fence[head]  = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);                              // Setting fence...
+        number[head] = captured++;                                                                  // Setting frame number...
+        head         = (head + 1)%pbo.size ();                                                      // Advancing ring...
+        busy++;                                                                                     // Occupying slot...
+
+        while(collect (false))
+        {
+          // Collecting completed slots...
+        }
+
+        glBindFramebuffer (GL_DRAW_FRAMEBUFFER, 0);                                                 // Binding window (draw)...
+        glBlitFramebuffer (
+                           0, 0, width, height,
+                           0, 0, width, height,
+                           GL_COLOR_BUFFER_BIT, GL_NEAREST
+                          );                                                                        // Copying frame on window...
+        glBindFramebuffer (GL_FRAMEBUFFER, 0);                                                      // Unbinding framebuffer...
+      }
+
+      /// @brief **Frames.**
+      /// @details It returns the number of captured frames.
+      size_t frames ()
+      {
+        return captured;
+      }
+
+      /// @brief **Class destructor.**
+      /// @details It collects the slots still in flight, lets the writer drain its queue and
+      /// deletes the OpenGL objects.
+      ~recorder ()
+      {
+        while(busy > 0)
+        {
+          collect (true);                                                                           // Collecting slot...
+        }
+
+        {
+          std::lock_guard<std::mutex> guard (lock);
+          stop = true;                                                                              // Requesting stop...
+        }
+
+        changed.notify_all ();                                                                      // Waking writer...
+        worker.join ();                                                                             // Waiting for writer...
+        glDeleteBuffers ((GLsizei)pbo.size (), pbo.data ());                                        // Deleting pixel buffers...
+        glDeleteRenderbuffers (1, &color);                                                          // Deleting color renderbuffer...
+        glDeleteRenderbuffers (1, &depth);                                                          // Deleting depth renderbuffer...
+        glDeleteFramebuffers (1, &fbo);                                                             // Deleting framebuffer...
+      }
+  };
+}
+
+#endif
@@ -0,0 +1,75 @@
+/// @file
+/// @details  Shared by the examples: the buffer bindings are defined by "examples::link_renderer"
+/// right after the version line. The link colors are RGBA8 words when COLOR_RGBA8 is defined,
+/// "vec4" otherwise. Each invocation computes only the billboard corner it emits.
+#version 460 core
+
+uniform mat4 P_mat;                                                             // Projection matrix.
+uniform float AR;                                                               // Framebuffer aspect ratio.
+
+layout(std430, binding = COLOR_BINDING) buffer voxel_color
+{
+#ifdef COLOR_RGBA8
+  uint color_SSBO[];                                                            // Voxel color SSBO (RGBA8).
+#else
+  vec4 color_SSBO[];                                                            // Voxel color SSBO.
+#endif
+};
+
+layout(std430, binding = NEAREST_BINDING) buffer voxel_nearest
+{
+  int nearest_SSBO[];                                                           // Voxel nearest SSBO.
+};
+
+layout(std430, binding = CLIP_BINDING) buffer voxel_clip
+{
+  vec4 clip_SSBO[];                                                             // Voxel position SSBO (in clip space).
+};
+
+layout(std430, binding = VISIBLE_BINDING) buffer voxel_visible
+{
+  uvec4 visible_SSBO[];                                                         // Visible link SSBO (link, central node, quad aspect ratio).
+};
+
+out vec4 color;                                                                 // Fragment color.
+out vec2 quad;                                                                  // Billboard quad UV coordinates.
+out float AR_quad;                                                              // Billboard quad aspect ratio.
+
+void main()
+{
+  uvec4 v = visible_SSBO[gl_InstanceID];                                        // Visible link (one instance per visible link).
+  uint corner = gl_VertexID;                                                    // Billboard corner (triangle strip "a", "b", "c", "d").
+  uint i = v.x;                                                                 // Link index.
+
+  vec2 V;                                                                       // Billboard corner (unit square).
+  vec4 N;                                                                       // Billboard corner node (in clip space).
+  vec4 P;                                                                       // Center node (in clip space).
+  vec4 Q;                                                                       // Neighbour node (in clip space).
+  vec2 link;                                                                    // PQ segment (in window space).
+  mat2 M;                                                                       // Billboard rotation matrix (in window space).
+  float s;                                                                      // Billboard thickness (in clip space).
+
+  s = 0.02;                                                                     // Setting billboard thickness (in clip space)...
+
+  // GETTING LINK NODES (already in clip space, the central node resolved by the culling pass):
+  P = clip_SSBO[v.y];                                                           // Getting center node (in clip space)...
+  Q = clip_SSBO[nearest_SSBO[i]];                                               // Getting neighbour node (in clip space)...
+
+  // COMPUTING BILLBOARD ROTATION:
+  link = normalize(vec2(AR*(Q.x/Q.w - P.x/P.w), (Q.y/Q.w - P.y/P.w)));          // Computing normalized PQ segment (in window space)...
+  M[0][0] = +link.x; M[0][1] = +link.y;                                         // Computing rotation matrix (in window space)...
+  M[1][0] = -link.y; M[1][1] = +link.x;                                         // Computing rotation matrix (in window space)...
+
+  // GENERATING BILLBOARD VERTEX ("a", "b" around the center node, "c", "d" around the neighbour):
+  V = vec2((corner < 2u) ? -0.5 : +0.5, ((corner & 1u) == 0u) ? +0.5 : -0.5);   // Selecting billboard corner...
+  N = (corner < 2u) ? P : Q;                                                    // Selecting billboard corner node...
+  gl_Position = N + P_mat*(s*vec4(M*V, 0.0, 1.0));                              // Setting billboard vertex (the projection is linear)...
+  AR_quad = uintBitsToFloat(v.z);                                               // Getting billboard aspect ratio (computed by the culling pass)...
+  quad = vec2(V.x*AR_quad, V.y);                                                // Setting quad vertex (in UV space)...
+
+#ifdef COLOR_RGBA8
+  color = unpackUnorm4x8(color_SSBO[i]);                                        // Setting voxel color...
+#else
+  color = color_SSBO[i];                                                        // Setting voxel color...
+#endif
+}
@@ -0,0 +1,190 @@
+/// @file     simd.hpp
+/// @brief    Node-wise SIMD packs.
+///
+/// @details  Node data are stored as arrays of 4-float structures (x, y, z, w). A "pack" holds the
+/// data of "nodes" consecutive nodes in one vector register: 4 nodes with AVX-512, 2 nodes with
+/// AVX2, 1 node otherwise. The same templated arithmetic runs on any pack, so the wide pack is used
+/// over the bulk of a range and the scalar one over its tail. Per-link data (neighbour indices,
+/// stiffness, resting lengths) are instead indexed per node: a "lane" pack holds one value for each
+/// of "lanes" consecutive nodes (16 with AVX-512, 8 with AVX2, 1 otherwise) and fetches them by
+/// masked gathers, so that the nodes of a pack walk their links together. The instruction set is
+/// chosen at compile time (e.g. "-mavx2" or "-march=native").
+
+#ifndef simd_hpp
+#define simd_hpp
+
+// INCLUDES:
+  #include <cstddef>                                                                                // Standard size types.
+  #include <cmath>                                                                                  // Standard math.
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+  #include <immintrin.h>                                                                            // Intel intrinsics.
+#endif
+
+namespace examples
+{
+  // SCALAR PACK (1 node):
+  struct simd_scalar
+  {
+    typedef struct {float v[4];} type;                                                              // Pack type.
+    static const size_t nodes = 1;                                                                  // Nodes per pack [#].
+
+    static type load (const float* p)                     {return {{p[0], p[1], p[2], p[3]}};}
+    static void store (float* p, type a)                  {for(int k = 0; k < 4; k++) p[k] = a.v[k];}
+    static type set1 (float s)                            {return {{s, s, s, s}};}
+    static type node (const float* s)                     {return set1 (s[0]);}
+    static type add (type a, type b)                      {for(int k = 0; k < 4; k++) a.v[k] += b.v[k]; return a;}
+    static type sub (type a, type b)                      {for(int k = 0; k < 4; k++) a.v[k] -= b.v[k]; return a;}
+    static type mul (type a, type b)                      {for(int k = 0; k < 4; k++) a.v[k] *= b.v[k]; return a;}
+    static type div (type a, type b)                      {for(int k = 0; k < 4; k++) a.v[k] /= b.v[k]; return a;}
+    static type projective (type a)                       {a.v[3] = 1.0f; return a;}
+  };
+
+  // SCALAR LANES (1 node):
+  struct lane_scalar
+  {
+    typedef float type;                                                                             // Lane type.
+    typedef int   index;                                                                            // Lane index type.
+    typedef bool  mask;                                                                             // Lane mask type.
+    static const size_t lanes = 1;                                                                  // Nodes per pack [#].
+
+    static type  load (const float* p)                    {return p[0];}
+    static void  store (float* p, type a)                 {p[0] = a;}
+    static type  set1 (float s)                           {return s;}
+    static index load_index (const int* p)                {return p[0];}
+    static void  store_index (int* p, index a)            {p[0] = a;}
+    static index add_index (index a, int b)               {return a + b;}
+    static mask  less (index a, index b)                  {return a < b;}
+    static bool  any (mask m)                             {return m;}
+    static index gather_index (const int* p, index i, mask m) {return m ? p[i] : 0;}
+    static type  gather (const float* p, index i, mask m) {return m ? p[i] : 0.0f;}
+    static type  gather_node (const float* p, index i, mask m) {return m ? p[4*i] : 0.0f;}
+    static type  add (type a, type b)                     {return a + b;}
+    static type  sub (type a, type b)                     {return a - b;}
+    static type  mul (type a, type b)                     {return a*b;}
+    static type  sqrt (type a)                            {return std::sqrt (a);}
+    static type  inverse (type a)                         {return (a > 0.0f) ? 1.0f/a : 0.0f;}
+  };
+
+#if defined(__AVX512F__)
+  // AVX-512 PACK (4 nodes):
+  struct simd_wide
+  {
+    typedef __m512 type;                                                                            // Pack type.
+    static const size_t nodes = 4;                                                                  // Nodes per pack [#].
+
+    static type load (const float* p)                     {return _mm512_loadu_ps (p);}
+    static void store (float* p, type a)                  {_mm512_storeu_ps (p, a);}
+    static type set1 (float s)                            {return _mm512_set1_ps (s);}
+    static type node (const float* s)
+    {
+      return _mm512_set_ps (s[3], s[3], s[3], s[3], s[2], s[2], s[2], s[2],
+                            s[1], s[1], s[1], s[1], s[0], s[0], s[0], s[0]);
+    }
+    static type add (type a, type b)                      {return _mm512_add_ps (a, b);}
+    static type sub (type a, type b)                      {return _mm512_sub_ps (a, b);}
+    static type mul (type a, type b)                      {return _mm512_mul_ps (a, b);}
+    static type div (type a, type b)                      {return _mm512_div_ps (a, b);}
+    static type projective (type a)                       {return _mm512_mask_blend_ps (0x8888, a, set1 (1.0f));}
+  };
+
+  // AVX-512 LANES (16 nodes):
+  struct lane_wide
+  {
+    typedef __m512    type;                                                                         // Lane type.
+    typedef __m512i   index;                                                                        // Lane index type.
+    typedef __mmask16 mask;                                                                         // Lane mask type.
+    static const size_t lanes = 16;                                                                 // Nodes per pack [#].
+
+    static type  load (const float* p)                    {return _mm512_loadu_ps (p);}
+    static void  store (float* p, type a)                 {_mm512_storeu_ps (p, a);}
+    static type  set1 (float s)                           {return _mm512_set1_ps (s);}
+    static index load_index (const int* p)                {return _mm512_loadu_si512 (p);}
+    static void  store_index (int* p, index a)            {_mm512_storeu_si512 (p, a);}
+    static index add_index (index a, int b)               {return _mm512_add_epi32 (a, _mm512_set1_epi32 (b));}
+    static mask  less (index a, index b)                  {return _mm512_cmplt_epi32_mask (a, b);}
+    static bool  any (mask m)                             {return m != 0;}
+    static index gather_index (const int* p, index i, mask m)
+    {
+      return _mm512_mask_i32gather_epi32 (_mm512_setzero_si512 (), m, i, p, 4);
+    }
+    static type  gather (const float* p, index i, mask m)
+    {
+      return _mm512_mask_i32gather_ps (_mm512_setzero_ps (), m, i, p, 4);
+    }
+    static type  gather_node (const float* p, index i, mask m)
+    {
+      return _mm512_mask_i32gather_ps (_mm512_setzero_ps (), m, _mm512_slli_epi32 (i, 2), p, 4);
+    }
+    static type  add (type a, type b)                     {return _mm512_add_ps (a, b);}
+    static type  sub (type a, type b)                     {return _mm512_sub_ps (a, b);}
+    static type  mul (type a, type b)                     {return _mm512_mul_ps (a, b);}
+    static type  sqrt (type a)                            {return _mm512_sqrt_ps (a);}
+    static type  inverse (type a)
+    {
+      return _mm512_maskz_div_ps (_mm512_cmp_ps_mask (a, _mm512_setzero_ps (), _CMP_GT_OQ), set1 (1.0f), a);
+    }
+  };
+#elif defined(__AVX2__)
+  // AVX2 PACK (2 nodes):
+  struct simd_wide
+  {
+    typedef __m256 type;                                                                            // Pack type.
+    static const size_t nodes = 2;                                                                  // Nodes per pack [#].
+
+    static type load (const float* p)                     {return _mm256_loadu_ps (p);}
+    static void store (float* p, type a)                  {_mm256_storeu_ps (p, a);}
+    static type set1 (float s)                            {return _mm256_set1_ps (s);}
+    static type node (const float* s)                     {return _mm256_set_m128 (_mm_set1_ps (s[1]), _mm_set1_ps (s[0]));}
+    static type add (type a, type b)                      {return _mm256_add_ps (a, b);}
+    static type sub (type a, type b)                      {return _mm256_sub_ps (a, b);}
+    static type mul (type a, type b)                      {return _mm256_mul_ps (a, b);}
+    static type div (type a, type b)                      {return _mm256_div_ps (a, b);}
+    static type projective (type a)                       {return _mm256_blend_ps (a, set1 (1.0f), 0x88);}
+  };
+
+  // AVX2 LANES (8 nodes):
+  struct lane_wide
+  {
+    typedef __m256  type;                                                                           // Lane type.
+    typedef __m256i index;                                                                          // Lane index type.
+    typedef __m256i mask;                                                                           // Lane mask type.
+    static const size_t lanes = 8;                                                                  // Nodes per pack [#].
+
+    static type  load (const float* p)                    {return _mm256_loadu_ps (p);}
+    static void  store (float* p, type a)                 {_mm256_storeu_ps (p, a);}
+    static type  set1 (float s)                           {return _mm256_set1_ps (s);}
+    static index load_index (const int* p)                {return _mm256_loadu_si256 ((const __m256i*)p);}
+    static void  store_index (int* p, index a)            {_mm256_storeu_si256 ((__m256i*)p, a);}
+    static index add_index (index a, int b)               {return _mm256_add_epi32 (a, _mm256_set1_epi32 (b));}
+    static mask  less (index a, index b)                  {return _mm256_cmpgt_epi32 (b, a);}
+    static bool  any (mask m)                             {return !_mm256_testz_si256 (m, m);}
+    static index gather_index (const int* p, index i, mask m)
+    {
+      return _mm256_mask_i32gather_epi32 (_mm256_setzero_si256 (), p, i, m, 4);
+    }
+    static type  gather (const float* p, index i, mask m)
+    {
+      return _mm256_mask_i32gather_ps (_mm256_setzero_ps (), p, i, _mm256_castsi256_ps (m), 4);
+    }
+    static type  gather_node (const float* p, index i, mask m)
+    {
+      return _mm256_mask_i32gather_ps (_mm256_setzero_ps (), p, _mm256_slli_epi32 (i, 2), _mm256_castsi256_ps (m), 4);
+    }
+    static type  add (type a, type b)                     {return _mm256_add_ps (a, b);}
+    static type  sub (type a, type b)                     {return _mm256_sub_ps (a, b);}
+    static type  mul (type a, type b)                     {return _mm256_mul_ps (a, b);}
+    static type  sqrt (type a)                            {return _mm256_sqrt_ps (a);}
+    static type  inverse (type a)
+    {
+      return _mm256_and_ps (_mm256_div_ps (set1 (1.0f), a), _mm256_cmp_ps (a, _mm256_setzero_ps (), _CMP_GT_OQ));
+    }
+  };
+#else
+  // NO VECTOR EXTENSIONS:
+  typedef simd_scalar simd_wide;
+  typedef lane_scalar lane_wide;
+#endif
+}
+
+#endif
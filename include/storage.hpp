@@ -0,0 +1,69 @@
+/// @file     storage.hpp
+/// @brief    OpenGL shader storage buffer owned by the rendering thread.
+///
+/// @details  The solver runs on its own thread on plain OpenCL buffers, not shared with OpenGL
+/// (INTEROP = false): it copies the data to be drawn into host snapshots, which the rendering thread
+/// uploads to these OpenGL buffers. Hence the buffers are only ever touched by the thread owning the
+/// OpenGL context. The buffer is attached to a fixed binding point of the GLSL "std430" layout.
+
+#ifndef storage_hpp
+#define storage_hpp
+
+// INCLUDES:
+  #include "nu.hpp"                                                                                 // Neutrino's header file.
+
+namespace examples
+{
+  class storage
+  {
+    private:
+      GLuint buffer;                                                                                // Buffer object.
+      GLuint binding;                                                                               // SSBO binding point.
+      size_t size;                                                                                  // Buffer size [bytes].
+
+    public:
+      /// @brief **Class constructor.**
+      storage (
+               GLuint loc_binding                                                                   // SSBO binding point.
+              )
+      {
+        binding = loc_binding;                                                                      // Setting binding point...
+        size    = 0;                                                                                // Setting size...
+        glGenBuffers (1, &buffer);                                                                  // Generating buffer...
+      }
+
+      /// @brief **Upload.**
+      /// @details It copies the data in the buffer and attaches it to its binding point. The buffer
+      /// is reallocated only when the data size changes.
+      template<typename T>
+      void upload (
+                   const std::vector<T>& loc_data                                                   // Data.
+                  )
+      {
+        size_t bytes = loc_data.size ()*sizeof(T);                                                  // Data size [bytes].
+
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, buffer);                                            // Binding buffer...
+
+        if(bytes != size)
+        {
+          glBufferData (GL_SHADER_STORAGE_BUFFER, bytes, loc_data.data (), GL_DYNAMIC_DRAW);        // Allocating buffer...
+          size = bytes;                                                                             // Setting size...
+        }
+        else
+        {
+          glBufferSubData (GL_SHADER_STORAGE_BUFFER, 0, bytes, loc_data.data ());                   // Updating buffer...
+        }
+
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, binding, buffer);                               // Attaching buffer...
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);                                                 // Unbinding buffer...
+      }
+
+      /// @brief **Class destructor.**
+      ~storage ()
+      {
+        glDeleteBuffers (1, &buffer);                                                               // Deleting buffer...
+      }
+  };
+}
+
+#endif
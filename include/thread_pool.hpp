@@ -0,0 +1,193 @@
+/// @file     thread_pool.hpp
+/// @brief    Work-stealing thread pool.
+///
+/// @details  A fixed set of worker threads executes a job over a range of blocks. The blocks are
+/// dealt round-robin to per-worker queues: each worker pops blocks from the back of its own queue
+/// and, when it runs dry, steals from the front of the other ones, so that blocks of uneven cost
+/// (e.g. nodes having more links) are balanced at run time. The calling thread waits until all
+/// blocks of the job have been executed.
+
+#ifndef thread_pool_hpp
+#define thread_pool_hpp
+
+// INCLUDES:
+  #include <vector>                                                                                 // Standard vector.
+  #include <deque>                                                                                  // Standard double-ended queue.
+  #include <memory>                                                                                 // Standard smart pointers.
+  #include <thread>                                                                                 // Standard threads.
+  #include <mutex>                                                                                  // Standard mutexes.
+  #include <condition_variable>                                                                     // Standard condition variables.
+  #include <atomic>                                                                                 // Standard atomics.
+  #include <functional>                                                                             // Standard function objects.
+
+namespace examples
+{
+  class thread_pool
+  {
+    private:
+      typedef struct
+      {
+        std::mutex         lock;                                                                    // Queue lock.
+        std::deque<size_t> block;                                                                   // Queued blocks.
+      } queue;
+
+      std::vector<std::thread>            worker;                                                   // Worker threads.
+      std::vector<std::unique_ptr<queue> > queues;                                                  // Worker queues.
+      std::function<void(size_t)>         job;                                                      // Current job.
+      std::mutex                          lock;                                                     // Pool lock.
+      std::condition_variable             wake;                                                     // Job start signal.
+      std::condition_variable             done;                                                     // Job end signal.
+      std::atomic<size_t>                 pending;                                                  // Blocks still to be executed [#].
+      size_t                              generation;                                               // Job counter [#].
+      bool                                stop;                                                     // Pool stop flag.
+
+      // Getting a block (own queue first, then stealing):
+      bool fetch (
+                  size_t  loc_worker,                                                               // Worker index.
+                  size_t& loc_block                                                                 // Block index.
+                 )
+      {
+        size_t i;                                                                                   // Index.
+        size_t k;                                                                                   // Queue index.
+
+        for(i = 0; i < queues.size (); i++)
+        {
+          k = (loc_worker + i)%queues.size ();                                                      // Visiting queues (own first)...
+          std::lock_guard<std::mutex> guard (queues[k]->lock);
+
+          if(!queues[k]->block.empty ())
+          {
+            if(i == 0)
+            {
+              loc_block = queues[k]->block.back ();                                                 // Popping own block...
+              queues[k]->block.pop_back ();
+            }
+            else
+            {
+              loc_block = queues[k]->block.front ();                                                // Stealing block...
+              queues[k]->block.pop_front ();
+            }
+
+            return true;
+          }
+        }
+
+        return false;
+      }
+
+      // Worker loop:
+      void work (
+                 size_t loc_worker                                                                  // Worker index.
+                )
+      {
+        size_t seen = 0;                                                                            // Last job seen.
+        size_t block;                                                                               // Block index.
+
+        while(true)
+        {
+          {
+            std::unique_lock<std::mutex> guard (lock);
+            wake.wait (guard, [&] () {return stop || (generation != seen);});                       // Waiting for a job...
+
+            if(stop)
+            {
+              return;
+            }
+
+            seen = generation;                                                                      // Taking job...
+          }
+
+          while(fetch (loc_worker, block))
+          {
+            job (block);                                                                            // Executing block...
+
+            if(pending.fetch_sub (1) == 1)
+            {
+              std::lock_guard<std::mutex> guard (lock);
+              done.notify_all ();                                                                   // Signaling job end...
+            }
+          }
+        }
+      }
+
+    public:
+      /// @brief **Class constructor.**
+      /// @details It starts the worker threads (at least one).
+      thread_pool (
+                   size_t loc_threads                                                               // Number of threads.
+                  )
+      {
+        size_t i;                                                                                   // Index.
+
+        pending    = 0;                                                                             // Resetting pending blocks...
+        generation = 0;                                                                             // Resetting job counter...
+        stop       = false;                                                                         // Resetting stop flag...
+
+        for(i = 0; i < std::max (loc_threads, (size_t)1); i++)
+        {
+          queues.emplace_back (new queue ());                                                       // Creating worker queue...
+        }
+
+        for(i = 0; i < queues.size (); i++)
+        {
+          worker.emplace_back (&thread_pool::work, this, i);                                        // Starting worker...
+        }
+      }
+
+      /// @brief **Number of threads.**
+      size_t threads ()
+      {
+        return worker.size ();
+      }
+
+      /// @brief **Job execution.**
+      /// @details It executes "loc_job" over blocks 0...loc_blocks - 1 and returns when all of them
+      /// have been executed.
+      void run (
+                size_t                      loc_blocks,                                             // Number of blocks.
+                std::function<void(size_t)> loc_job                                                 // Job.
+               )
+      {
+        size_t i;                                                                                   // Index.
+
+        if(loc_blocks == 0)
+        {
+          return;
+        }
+
+        std::unique_lock<std::mutex> guard (lock);
+        job     = loc_job;                                                                          // Setting job...
+        pending = loc_blocks;                                                                       // Setting pending blocks...
+
+        for(i = 0; i < loc_blocks; i++)
+        {
+          std::lock_guard<std::mutex> queue_guard (queues[i%queues.size ()]->lock);
+          queues[i%queues.size ()]->block.push_back (i);                                            // Dealing block...
+        }
+
+        generation++;                                                                               // Starting job...
+        wake.notify_all ();                                                                         // Waking workers...
+        done.wait (guard, [&] () {return pending == 0;});                                           // Waiting for job end...
+      }
+
+      /// @brief **Class destructor.**
+      ~thread_pool ()
+      {
+        size_t i;                                                                                   // Index.
+
+        {
+          std::lock_guard<std::mutex> guard (lock);
+          stop = true;                                                                              // Stopping workers...
+        }
+
+        wake.notify_all ();                                                                         // Waking workers...
+
+        for(i = 0; i < worker.size (); i++)
+        {
+          worker[i].join ();                                                                        // Joining worker...
+        }
+      }
+  };
+}
+
+#endif
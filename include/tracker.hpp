@@ -0,0 +1,90 @@
+/// @file     tracker.hpp
+/// @brief    Change tracker.
+///
+/// @details  Every buffer carries a version number, bumped each time something writes it. A
+/// consumer (e.g. a kernel, or the rendered frame) records the versions of its inputs when it runs,
+/// so that it can tell whether any of them has changed since then and skip its work otherwise.
+/// Values that are not buffers (e.g. the camera state) are tracked by comparing them against their
+/// last snapshot instead.
+
+#ifndef tracker_hpp
+#define tracker_hpp
+
+// INCLUDES:
+  #include <vector>                                                                                 // Standard vector.
+  #include <map>                                                                                    // Standard map.
+  #include <string>                                                                                 // Standard string.
+  #include <cmath>                                                                                  // Standard math.
+
+namespace examples
+{
+  class tracker
+  {
+    private:
+      std::map<size_t, size_t>                          version;                                    // Buffer versions.
+      std::map<std::string, std::map<size_t, size_t> > seen;                                        // Buffer versions seen by each consumer.
+      std::map<std::string, std::vector<float> >        snapshot;                                   // Last value snapshots.
+
+    public:
+      /// @brief **Touch.**
+      /// @details It marks a buffer (e.g. by its Neutrino layout index) as written.
+      void touch (
+                  size_t loc_buffer                                                                 // Buffer.
+                 )
+      {
+        version[loc_buffer]++;                                                                      // Bumping version...
+      }
+
+      /// @brief **Dirty.**
+      /// @details It returns "true" if any input buffer has been written since the last time the
+      /// consumer called it (or if the consumer never called it), then marks all inputs as seen.
+      bool dirty (
+                  std::string         loc_consumer,                                                 // Consumer.
+                  std::vector<size_t> loc_input                                                     // Input buffers.
+                 )
+      {
+        std::map<size_t, size_t>& last  = seen[loc_consumer];                                       // Versions seen by consumer.
+        bool                      stale = false;                                                    // Stale flag.
+        size_t                    i;                                                                // Index.
+
+        for(i = 0; i < loc_input.size (); i++)
+        {
+          if((last.count (loc_input[i]) == 0) || (last[loc_input[i]] != version[loc_input[i]]))
+          {
+            stale              = true;                                                              // Setting stale flag...
+            last[loc_input[i]] = version[loc_input[i]];                                             // Marking input as seen...
+          }
+        }
+
+        return stale;
+      }
+
+      /// @brief **Changed.**
+      /// @details It returns "true" if any element of a value differs from its last snapshot by
+      /// more than "loc_tolerance" (or if there is no snapshot yet), then takes a new snapshot.
+      bool changed (
+                    std::string               loc_name,                                             // Value name.
+                    const std::vector<float>& loc_value,                                            // Value.
+                    float                     loc_tolerance                                         // Tolerance.
+                   )
+      {
+        std::vector<float>& last   = snapshot[loc_name];                                            // Last snapshot.
+        bool                change = (last.size () != loc_value.size ());                           // Change flag.
+        size_t              i;                                                                      // Index.
+
+        for(i = 0; (i < loc_value.size ()) && !change; i++)
+        {
+          change = (std::fabs (loc_value[i] - last[i]) > loc_tolerance);                            // Comparing element...
+        }
+
+        if(change)
+        {
+          last = loc_value;                                                                         // Taking snapshot...
+        }
+
+        return change;
+      }
+  };
+}
+
+#endif
@@ -0,0 +1,125 @@
+/// @file     triple_buffer.hpp
+/// @brief    Lock-free triple buffer.
+///
+/// @details  A single producer and a single consumer exchange snapshots through three slots: the
+/// producer fills the "back" slot and publishes it, the consumer takes the most recently published
+/// one as its "front" slot. The third slot sits in the middle and is swapped atomically, so
+/// neither side ever waits for the other: the producer can publish at its own rate and the consumer
+/// always gets the latest completed snapshot (intermediate ones are dropped). A side that has to
+/// wait for the other one (a producer publishing only taken snapshots, a consumer needing a new
+/// one) can block on a condition variable instead of spinning: the exchange itself stays lock-free,
+/// the lock is held only around the notifications.
+
+#ifndef triple_buffer_hpp
+#define triple_buffer_hpp
+
+// INCLUDES:
+  #include <atomic>                                                                                 // Standard atomics.
+  #include <mutex>                                                                                  // Standard mutexes.
+  #include <condition_variable>                                                                     // Standard condition variables.
+  #include <chrono>                                                                                 // Standard clocks.
+
+namespace examples
+{
+  template<typename T>
+  class triple_buffer
+  {
+    private:
+      static const int        FRESH = 4;                                                            // "Middle slot not yet taken" flag.
+      T                       slot[3];                                                              // Slots.
+      std::atomic<int>        middle;                                                               // Middle slot index (+ FRESH flag).
+      int                     back;                                                                 // Producer slot index.
+      int                     front;                                                                // Consumer slot index.
+      std::mutex              lock;                                                                 // Wait lock.
+      std::condition_variable signal;                                                               // Publish/take signal.
+
+      // Notifying waiting side:
+      void notify ()
+      {
+        {
+          std::lock_guard<std::mutex> guard (lock);
+        }
+
+        signal.notify_all ();                                                                       // Waking waiting side...
+      }
+
+    public:
+      /// @brief **Class constructor.**
+      triple_buffer ()
+      {
+        back  = 0;                                                                                  // Setting producer slot...
+        middle.store (1);                                                                           // Setting middle slot...
+        front = 2;                                                                                  // Setting consumer slot...
+      }
+
+      /// @brief **Producer slot.**
+      /// @details It returns the slot the producer is allowed to fill.
+      T& write_buffer ()
+      {
+        return slot[back];
+      }
+
+      /// @brief **Publishing.**
+      /// @details It makes the producer slot the latest snapshot and recycles the middle one.
+      void publish ()
+      {
+        back = middle.exchange (back | FRESH, std::memory_order_acq_rel) & 3;                       // Swapping back and middle slots...
+        notify ();                                                                                  // Notifying consumer...
+      }
+
+      /// @brief **Pending snapshot check.**
+      /// @details It returns "true" if the last published snapshot has not been taken yet.
+      bool pending ()
+      {
+        return (middle.load (std::memory_order_acquire) & FRESH) != 0;
+      }
+
+      /// @brief **Taking.**
+      /// @details It returns "true" and swaps in the latest snapshot if a new one was published.
+      bool take ()
+      {
+        if(!pending ())
+        {
+          return false;
+        }
+
+        front = middle.exchange (front, std::memory_order_acq_rel) & 3;                             // Swapping front and middle slots...
+        notify ();                                                                                  // Notifying producer...
+
+        return true;
+      }
+
+      /// @brief **Waiting for a snapshot (consumer).**
+      /// @details It blocks until a snapshot is pending or "loc_timeout" has elapsed and returns
+      /// "true" if one is pending.
+      bool wait_published (
+                           std::chrono::milliseconds loc_timeout                                    // Timeout [ms].
+                          )
+      {
+        std::unique_lock<std::mutex> guard (lock);
+
+        return signal.wait_for (guard, loc_timeout, [this]{return pending ();});
+      }
+
+      /// @brief **Waiting for the snapshot to be taken (producer).**
+      /// @details It blocks until the last published snapshot has been taken or "loc_timeout" has
+      /// elapsed and returns "true" if it has been taken.
+      bool wait_taken (
+                       std::chrono::milliseconds loc_timeout                                        // Timeout [ms].
+                      )
+      {
+        std::unique_lock<std::mutex> guard (lock);
+
+        return signal.wait_for (guard, loc_timeout, [this]{return !pending ();});
+      }
+
+      /// @brief **Consumer slot.**
+      /// @details It returns the latest snapshot taken by the consumer.
+      T& read_buffer ()
+      {
+        return slot[front];
+      }
+  };
+}
+
+#endif